@@ -21,36 +21,27 @@
 #include <stdarg.h>
 #include <GLPS/glps_thread.h>
 #include <sys/select.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <stdint.h>
 #include <pwd.h>
 #include <sys/stat.h>
+#include <sched.h>
 PrecomputedAtoms atoms;
-Window *opened_windows = NULL;
-int opened_windows_count = 0;
-int opened_windows_capacity = 0;
+_Atomic(OpenedWindowSet *) opened_windows = NULL;
+atomic_int opened_windows_readers = 0;
+static OpenedWindowSet *retired_window_sets[MAX_RETIRED_WINDOW_SETS];
+static int retired_window_set_count = 0;
 volatile int dbus_thread_running = 0;
 gthread_t dbus_thread;
 gthread_mutex_t dbus_mutex;
 gthread_mutex_t window_list_mutex;
 int window_list_update_pending = 0;
+int dbus_wake_fd = -1;
+static DBusWatch *dbus_watches[MAX_DBUS_WATCHES];
+static int dbus_watch_count = 0;
+static unsigned long dbus_watch_generation = 0;
 int pending_x_flush = 0;
-void LogError(const char *message, ...)
-{
-    va_list args;
-    va_start(args, message);
-    fprintf(stderr, "[ERROR] ");
-    vfprintf(stderr, message, args);
-    fprintf(stderr, "\n");
-    va_end(args);
-}
-void LogInfo(const char *message, ...)
-{
-    va_list args;
-    va_start(args, message);
-    printf("[INFO] ");
-    vprintf(message, args);
-    printf("\n");
-    va_end(args);
-}
 void SafeXFree(void *data)
 {
     if (data != NULL)
@@ -75,24 +66,32 @@ void SendWallpaperChangeThroughDBus(GooeyShellState *state, const char *wallpape
     }
     dbus_message_iter_init_append(message, &args);
     dbus_message_iter_append_basic(&args, DBUS_TYPE_STRING, &wallpaper_path);
-    dbus_connection_send(state->dbus_connection, message, NULL);
-    dbus_connection_flush(state->dbus_connection);
-    dbus_message_unref(message);
+    EmitShellSignal(state, message);
     LogInfo("SendWallpaperChangeThroughDBus: Sent wallpaper change signal: %s", wallpaper_path);
 }
-void SendWallpaperChangeIfReady(GooeyShellState *state, const char *wallpaper_path)
+static void SendWallpaperChangeTimer(GooeyShellState *state, void *data)
 {
-    if ((state->dbus_connection == NULL) || (state->is_dbus_init == false))
+    (void)data;
+    if ((state->dbus_connection == NULL) || (state->is_dbus_init == false) || (dbus_thread_running == 0))
     {
         return;
     }
-    int attempts = 0;
-    while (attempts < 10 && dbus_thread_running && state->is_dbus_init)
+    SendWallpaperChangeThroughDBus(state, state->wallpaper_path);
+    state->wallpaper_announce_attempts++;
+    if (state->wallpaper_announce_attempts < 10)
+    {
+        (void)AddTimer(state, 50, SendWallpaperChangeTimer, NULL);
+    }
+}
+void SendWallpaperChangeIfReady(GooeyShellState *state, const char *wallpaper_path)
+{
+    (void)wallpaper_path;
+    if ((state->dbus_connection == NULL) || (state->is_dbus_init == false))
     {
-        SendWallpaperChangeThroughDBus(state, wallpaper_path);
-        usleep(50000);
-        attempts++;
+        return;
     }
+    state->wallpaper_announce_attempts = 0;
+    (void)AddTimer(state, 0, SendWallpaperChangeTimer, NULL);
 }
 GooeyShellState *GooeyShell_Init(void)
 {
@@ -104,6 +103,15 @@ GooeyShellState *GooeyShell_Init(void)
         LogError("GooeyShell_Init: Failed to allocate GooeyShellState");
         return NULL;
     }
+    state->epoll_fd = -1;
+    state->signal_fd = -1;
+    state->timer_fd = -1;
+    state->command_event_fd = -1;
+    BlockShellSignals();
+    if (InitializeLogger() == 0)
+    {
+        fprintf(stderr, "GooeyShell_Init: Failed to start log flusher, logging synchronously\n");
+    }
     if (glps_thread_mutex_init(&dbus_mutex, NULL) != 0)
     {
         LogError("GooeyShell_Init: Failed to initialize DBus mutex");
@@ -133,6 +141,7 @@ GooeyShellState *GooeyShell_Init(void)
     state->focused_window = None;
     state->drag_window = None;
     state->is_tiling_resizing = False;
+    state->motion_commit_timer = -1;
     state->window_list = NULL;
     state->workspaces = NULL;
     state->monitor_info.monitors = NULL;
@@ -145,6 +154,19 @@ GooeyShellState *GooeyShell_Init(void)
         return NULL;
     }
     InitializeAtoms(state->display);
+    if (InitializeEventLoop(state) == 0)
+    {
+        LogError("GooeyShell_Init: Failed to initialize event loop");
+        GooeyShell_Cleanup(state);
+        return NULL;
+    }
+    InitializeSpawner(state);
+    if (InitializeCommandQueue(state) == 0)
+    {
+        LogError("GooeyShell_Init: Failed to initialize command queue");
+        GooeyShell_Cleanup(state);
+        return NULL;
+    }
     state->gc = XCreateGC(state->display, state->root, 0, NULL);
     if (state->gc == NULL)
     {
@@ -173,7 +195,8 @@ GooeyShellState *GooeyShell_Init(void)
     state->logout_command = strdup("killall gooey_shell");
     (void)GooeyShell_LoadConfig(state, state->config_file);
     gcv.foreground = state->titlebar_color;
-    state->titlebar_gc = XCreateGC(state->display, state->root, GCForeground, &gcv);
+    gcv.graphics_exposures = False;
+    state->titlebar_gc = XCreateGC(state->display, state->root, GCForeground | GCGraphicsExposures, &gcv);
     gcv.foreground = state->text_color;
     state->text_gc = XCreateGC(state->display, state->root, GCForeground, &gcv);
     gcv.foreground = state->button_color;
@@ -203,9 +226,6 @@ GooeyShellState *GooeyShell_Init(void)
     GrabKeys(state);
     LaunchDesktopAppsForAllMonitors(state);
     XFlush(state->display);
-    opened_windows = NULL;
-    opened_windows_count = 0;
-    opened_windows_capacity = 0;
     state->is_dbus_init = false;
     SetupDBUS(state);
     SendWallpaperChangeIfReady(state, state->wallpaper_path);
@@ -219,19 +239,14 @@ void LaunchAppMenu(GooeyShellState *state)
         LogError("LaunchAppMenu: NULL state pointer");
         return;
     }
-    pid = fork();
-    if (pid == 0)
-    {
-        execl("/usr/local/bin/gooeyde_appmenu", "/usr/local/bin/gooeyde_appmenu", NULL);
-        exit(1);
-    }
-    else if (pid > 0)
+    pid = SpawnProcess(state, "/usr/local/bin/gooeyde_appmenu", NULL, NULL, NULL);
+    if (pid > 0)
     {
         LogInfo("LaunchAppMenu: Menu launched with PID %d", pid);
     }
     else
     {
-        LogError("LaunchAppMenu: Fork failed");
+        LogError("LaunchAppMenu: Spawn failed");
     }
 }
 void ScheduleWindowListUpdate(GooeyShellState *state)
@@ -281,7 +296,7 @@ void HandleSetWallpaperCommand(GooeyShellState *state, DBusMessage *msg)
     LogInfo("HandleSetWallpaperCommand: Received wallpaper path: %s", wallpaper_path);
     if (access(wallpaper_path, F_OK) != 0)
     {
-        reply = dbus_message_new_error(msg, "FileNotFound", "Wallpaper file does not exist");
+        reply = dbus_message_new_error(msg, DBUS_ERROR_FILE_NOT_FOUND, "Wallpaper file does not exist");
         if (reply != NULL)
         {
             dbus_connection_send(state->dbus_connection, reply, NULL);
@@ -290,9 +305,14 @@ void HandleSetWallpaperCommand(GooeyShellState *state, DBusMessage *msg)
         }
         return;
     }
-    SendWallpaperChangeThroughDBus(state, wallpaper_path);
-    WriteConfigKey(state->config_file, "wallpaper_path", wallpaper_path);
-    reply = dbus_message_new_method_return(msg);
+    if (EnqueueShellCommand(state, SHELL_COMMAND_SET_WALLPAPER, None, wallpaper_path) != 0)
+    {
+        reply = dbus_message_new_error(msg, SHELL_ERROR_QUEUE_FULL, "Shell command queue is full");
+    }
+    else
+    {
+        reply = dbus_message_new_method_return(msg);
+    }
     if (reply != NULL)
     {
         dbus_connection_send(state->dbus_connection, reply, NULL);
@@ -324,16 +344,16 @@ void ProcessDBusMessage(GooeyShellState *state, DBusMessage *msg)
         dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY,
                                          DBUS_TYPE_STRING_AS_STRING,
                                          &array_iter);
-        glps_thread_mutex_lock(&window_list_mutex);
-        for (int i = 0; i < opened_windows_count; i++)
+        const OpenedWindowSet *set = AcquireOpenedWindows();
+        for (int i = 0; (set != NULL) && (i < set->count); i++)
         {
             char window_id[32];
             const char *window_str = NULL;
-            (void)snprintf(window_id, sizeof(window_id), "%lu", opened_windows[i]);
+            (void)snprintf(window_id, sizeof(window_id), "%lu", set->windows[i]);
             window_str = window_id;
             dbus_message_iter_append_basic(&array_iter, DBUS_TYPE_STRING, &window_str);
         }
-        glps_thread_mutex_unlock(&window_list_mutex);
+        ReleaseOpenedWindows();
         dbus_message_iter_close_container(&args, &array_iter);
         dbus_connection_send(state->dbus_connection, reply, NULL);
         dbus_connection_flush(state->dbus_connection);
@@ -346,11 +366,90 @@ void ProcessDBusMessage(GooeyShellState *state, DBusMessage *msg)
     {
         HandleDBusWindowCommand(state, msg);
     }
+    else if (dbus_message_is_method_call(msg, "dev.binaryink.gshell", "GetDesktopAppStatus") != 0)
+    {
+        HandleDesktopAppStatusCommand(state, msg);
+    }
+    else if (dbus_message_is_method_call(msg, "dev.binaryink.gshell", "GetWindowSnapshot") != 0)
+    {
+        HandleWindowSnapshotCommand(state, msg);
+    }
+    else if (dbus_message_is_method_call(msg, "dev.binaryink.gshell", "GetWindowChangesSince") != 0)
+    {
+        HandleWindowChangesCommand(state, msg);
+    }
+    else if (dbus_message_is_method_call(msg, "dev.binaryink.gshell", "GetStats") != 0)
+    {
+        HandleGetStatsCommand(state, msg);
+    }
+    else if (dbus_message_is_method_call(msg, "dev.binaryink.gshell", "ResetStats") != 0)
+    {
+        HandleResetStatsCommand(state, msg);
+    }
+    else if (dbus_message_is_method_call(msg, "dev.binaryink.gshell", "DumpTrace") != 0)
+    {
+        HandleDumpTraceCommand(state, msg);
+    }
+    else if (dbus_message_is_method_call(msg, "dev.binaryink.gshell", "GetPoolStats") != 0)
+    {
+        HandlePoolStatsCommand(state, msg);
+    }
+}
+static dbus_bool_t AddDBusWatch(DBusWatch *watch, void *data)
+{
+    (void)data;
+    glps_thread_mutex_lock(&dbus_mutex);
+    if (dbus_watch_count >= MAX_DBUS_WATCHES)
+    {
+        glps_thread_mutex_unlock(&dbus_mutex);
+        LogError("AddDBusWatch: Too many DBus watches");
+        return FALSE;
+    }
+    dbus_watches[dbus_watch_count] = watch;
+    dbus_watch_count++;
+    glps_thread_mutex_unlock(&dbus_mutex);
+    WakeDBusThread();
+    return TRUE;
+}
+static void RemoveDBusWatch(DBusWatch *watch, void *data)
+{
+    int i = 0;
+    (void)data;
+    glps_thread_mutex_lock(&dbus_mutex);
+    for (i = 0; i < dbus_watch_count; i++)
+    {
+        if (dbus_watches[i] == watch)
+        {
+            dbus_watches[i] = dbus_watches[dbus_watch_count - 1];
+            dbus_watch_count--;
+            dbus_watch_generation++;
+            break;
+        }
+    }
+    glps_thread_mutex_unlock(&dbus_mutex);
+    WakeDBusThread();
+}
+static void ToggleDBusWatch(DBusWatch *watch, void *data)
+{
+    (void)watch;
+    (void)data;
+    WakeDBusThread();
+}
+void WakeDBusThread(void)
+{
+    uint64_t one = 1;
+    if (dbus_wake_fd >= 0)
+    {
+        (void)write(dbus_wake_fd, &one, sizeof(one));
+    }
 }
 void *DBusListenerThread(void *arg)
 {
     GooeyShellState *state = NULL;
     int dbus_initialized = 0;
+    struct pollfd fds[MAX_DBUS_WATCHES + 1];
+    DBusWatch *polled[MAX_DBUS_WATCHES + 1];
+    unsigned long generation = 0;
     state = (GooeyShellState *)arg;
     if ((state == NULL) || (state->dbus_connection == NULL))
     {
@@ -359,6 +458,9 @@ void *DBusListenerThread(void *arg)
     LogInfo("DBusListenerThread: DBus listener thread started");
     while (dbus_thread_running != 0)
     {
+        int nfds = 0;
+        int i = 0;
+        DBusMessage *msg = NULL;
         glps_thread_mutex_lock(&dbus_mutex);
         dbus_initialized = state->is_dbus_init;
         glps_thread_mutex_unlock(&dbus_mutex);
@@ -366,18 +468,81 @@ void *DBusListenerThread(void *arg)
         {
             break;
         }
-        if (dbus_connection_read_write(state->dbus_connection, 10) == 0)
-        {
-            usleep(10000);
-            continue;
-        }
-        DBusMessage *msg = NULL;
         while ((msg = dbus_connection_pop_message(state->dbus_connection)) != NULL)
         {
+            unsigned long long start_ns = GetMonotonicTimeNs();
             ProcessDBusMessage(state, msg);
+            RecordDBusStats(state, dbus_message_get_member(msg), GetMonotonicTimeNs() - start_ns);
             dbus_message_unref(msg);
         }
-        usleep(5000);
+        fds[0].fd = dbus_wake_fd;
+        fds[0].events = POLLIN;
+        fds[0].revents = 0;
+        polled[0] = NULL;
+        nfds = 1;
+        glps_thread_mutex_lock(&dbus_mutex);
+        generation = dbus_watch_generation;
+        for (i = 0; i < dbus_watch_count; i++)
+        {
+            unsigned int flags = 0;
+            if (dbus_watch_get_enabled(dbus_watches[i]) == 0)
+            {
+                continue;
+            }
+            flags = dbus_watch_get_flags(dbus_watches[i]);
+            fds[nfds].fd = dbus_watch_get_unix_fd(dbus_watches[i]);
+            fds[nfds].events = (short)((((flags & DBUS_WATCH_READABLE) != 0) ? POLLIN : 0) |
+                                       (((flags & DBUS_WATCH_WRITABLE) != 0) ? POLLOUT : 0));
+            fds[nfds].revents = 0;
+            polled[nfds] = dbus_watches[i];
+            nfds++;
+        }
+        glps_thread_mutex_unlock(&dbus_mutex);
+        if (poll(fds, (nfds_t)nfds, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            LogError("DBusListenerThread: poll failed: %s", strerror(errno));
+            break;
+        }
+        if ((fds[0].revents & POLLIN) != 0)
+        {
+            uint64_t value = 0;
+            (void)read(dbus_wake_fd, &value, sizeof(value));
+        }
+        glps_thread_mutex_lock(&dbus_mutex);
+        if (generation != dbus_watch_generation)
+        {
+            nfds = 1;
+        }
+        glps_thread_mutex_unlock(&dbus_mutex);
+        for (i = 1; i < nfds; i++)
+        {
+            unsigned int flags = 0;
+            if (fds[i].revents == 0)
+            {
+                continue;
+            }
+            if ((fds[i].revents & POLLIN) != 0)
+            {
+                flags |= DBUS_WATCH_READABLE;
+            }
+            if ((fds[i].revents & POLLOUT) != 0)
+            {
+                flags |= DBUS_WATCH_WRITABLE;
+            }
+            if ((fds[i].revents & POLLHUP) != 0)
+            {
+                flags |= DBUS_WATCH_HANGUP;
+            }
+            if ((fds[i].revents & POLLERR) != 0)
+            {
+                flags |= DBUS_WATCH_ERROR;
+            }
+            (void)dbus_watch_handle(polled[i], flags);
+        }
     }
     LogInfo("DBusListenerThread: DBus listener thread stopped");
     return NULL;
@@ -425,60 +590,25 @@ void SetupDBUS(GooeyShellState *state)
         dbus_error_free(&state->dbus_error);
         return;
     }
-    state->is_dbus_init = true;
-    dbus_thread_running = 1;
-    if (glps_thread_create(&dbus_thread, NULL, DBusListenerThread, state) != 0)
-    {
-        LogError("SetupDBUS: Failed to create DBus thread");
-        state->is_dbus_init = false;
-    }
-}
-void SendWindowStateThroughDBus(GooeyShellState *state, Window window, const char *state_str)
-{
-    DBusMessage *message = NULL;
-    DBusMessageIter args;
-    char window_id[64];
-    if ((state->dbus_connection == NULL) || (state->is_dbus_init == false))
-    {
-        return;
-    }
-    message = dbus_message_new_signal("/dev/binaryink/gshell",
-                                      "dev.binaryink.gshell",
-                                      "WindowStateChanged");
-    if (message == NULL)
+    dbus_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (dbus_wake_fd < 0)
     {
+        LogError("SetupDBUS: Failed to create wake eventfd: %s", strerror(errno));
         return;
     }
-    dbus_message_iter_init_append(message, &args);
-    (void)snprintf(window_id, sizeof(window_id), "%lu", window);
-    const char *window_str = window_id;
-    dbus_message_iter_append_basic(&args, DBUS_TYPE_STRING, &window_str);
-    dbus_message_iter_append_basic(&args, DBUS_TYPE_STRING, &state_str);
-    dbus_connection_send(state->dbus_connection, message, NULL);
-    dbus_connection_flush(state->dbus_connection);
-    dbus_message_unref(message);
-}
-void SendWorkspaceChangedThroughDBus(GooeyShellState *state, int old_workspace, int new_workspace)
-{
-    DBusMessage *message = NULL;
-    DBusMessageIter args;
-    if ((state->dbus_connection == NULL) || (state->is_dbus_init == false))
+    if (dbus_connection_set_watch_functions(state->dbus_connection, AddDBusWatch, RemoveDBusWatch,
+                                            ToggleDBusWatch, state, NULL) == 0)
     {
+        LogError("SetupDBUS: Failed to install DBus watch functions");
         return;
     }
-    message = dbus_message_new_signal("/dev/binaryink/gshell",
-                                      "dev.binaryink.gshell",
-                                      "WorkspaceChanged");
-    if (message == NULL)
+    state->is_dbus_init = true;
+    dbus_thread_running = 1;
+    if (glps_thread_create(&dbus_thread, NULL, DBusListenerThread, state) != 0)
     {
-        return;
+        LogError("SetupDBUS: Failed to create DBus thread");
+        state->is_dbus_init = false;
     }
-    dbus_message_iter_init_append(message, &args);
-    dbus_message_iter_append_basic(&args, DBUS_TYPE_INT32, &old_workspace);
-    dbus_message_iter_append_basic(&args, DBUS_TYPE_INT32, &new_workspace);
-    dbus_connection_send(state->dbus_connection, message, NULL);
-    dbus_connection_flush(state->dbus_connection);
-    dbus_message_unref(message);
 }
 void HandleDBusWindowCommand(GooeyShellState *state, DBusMessage *msg)
 {
@@ -487,7 +617,7 @@ void HandleDBusWindowCommand(GooeyShellState *state, DBusMessage *msg)
     const char *window_id_str = NULL;
     const char *command = NULL;
     Window window = 0;
-    WindowNode *node = NULL;
+    int type = -1;
     DBusMessage *reply = NULL;
     if ((state == NULL) || (msg == NULL))
     {
@@ -525,51 +655,53 @@ void HandleDBusWindowCommand(GooeyShellState *state, DBusMessage *msg)
     {
         return;
     }
-    node = FindWindowNodeByFrame(state, window);
-    if (node == NULL)
-    {
-        return;
-    }
     if ((strcmp(method, "SendWindowCommand") == 0) && (command != NULL))
     {
         if (strcmp(command, "minimize") == 0)
         {
-            MinimizeWindow(state, node);
+            type = SHELL_COMMAND_MINIMIZE;
         }
         else if (strcmp(command, "restore") == 0)
         {
-            RestoreWindow(state, node);
+            type = SHELL_COMMAND_RESTORE;
         }
         else if (strcmp(command, "close") == 0)
         {
-            CloseWindow(state, node);
+            type = SHELL_COMMAND_CLOSE;
         }
         else if (strcmp(command, "toggle_tiling") == 0)
         {
-            GooeyShell_ToggleFloating(state, node->client);
+            type = SHELL_COMMAND_TOGGLE_TILING;
         }
         else if (strcmp(command, "focus_next") == 0)
         {
-            GooeyShell_FocusNextWindow(state);
+            type = SHELL_COMMAND_FOCUS_NEXT;
         }
         else if (strcmp(command, "focus_previous") == 0)
         {
-            GooeyShell_FocusPreviousWindow(state);
+            type = SHELL_COMMAND_FOCUS_PREVIOUS;
         }
     }
     else if (strcmp(method, "minimize") == 0)
     {
-        MinimizeWindow(state, node);
+        type = SHELL_COMMAND_MINIMIZE;
     }
     else if (strcmp(method, "RestoreWindow") == 0)
     {
-        RestoreWindow(state, node);
+        type = SHELL_COMMAND_RESTORE;
     }
     else if (strcmp(method, "CloseWindow") == 0)
     {
-        CloseWindow(state, node);
+        type = SHELL_COMMAND_CLOSE;
+    }
+    if ((type >= 0) && (EnqueueShellCommand(state, (ShellCommandType)type, window, NULL) != 0))
+    {
+        reply = dbus_message_new_error(msg, SHELL_ERROR_QUEUE_FULL, "Shell command queue is full");
+    }
+    else
+    {
+        reply = dbus_message_new_method_return(msg);
     }
-    reply = dbus_message_new_method_return(msg);
     if (reply != NULL)
     {
         dbus_connection_send(state->dbus_connection, reply, NULL);
@@ -586,60 +718,126 @@ int ValidateWindowState(GooeyShellState *state)
     }
     return 1;
 }
-void AddToOpenedWindows(Window window)
+const OpenedWindowSet *AcquireOpenedWindows(void)
+{
+    atomic_fetch_add(&opened_windows_readers, 1);
+    return atomic_load(&opened_windows);
+}
+void ReleaseOpenedWindows(void)
+{
+    atomic_fetch_sub(&opened_windows_readers, 1);
+}
+static void ReclaimOpenedWindowSets(int wait_for_readers)
 {
-    glps_thread_mutex_lock(&window_list_mutex);
-    if (opened_windows_count >= opened_windows_capacity)
+    int i = 0;
+    while ((wait_for_readers != 0) && (atomic_load(&opened_windows_readers) != 0))
     {
-        int new_capacity = 0;
-        Window *new_array = NULL;
-        new_capacity = (opened_windows_capacity == 0) ? 16 : opened_windows_capacity * 2;
-        new_array = realloc(opened_windows, (size_t)new_capacity * sizeof(Window));
-        if (new_array == NULL)
-        {
-            LogError("AddToOpenedWindows: Failed to realloc opened_windows");
-            glps_thread_mutex_unlock(&window_list_mutex);
-            return;
-        }
-        opened_windows = new_array;
-        opened_windows_capacity = new_capacity;
+        sched_yield();
+    }
+    if (atomic_load(&opened_windows_readers) != 0)
+    {
+        return;
     }
-    opened_windows[opened_windows_count] = window;
-    opened_windows_count++;
-    glps_thread_mutex_unlock(&window_list_mutex);
+    for (i = 0; i < retired_window_set_count; i++)
+    {
+        free(retired_window_sets[i]);
+        retired_window_sets[i] = NULL;
+    }
+    retired_window_set_count = 0;
 }
-void RemoveFromOpenedWindows(Window window)
+static void PublishOpenedWindows(OpenedWindowSet *set)
 {
-    int i = 0;
-    glps_thread_mutex_lock(&window_list_mutex);
-    for (i = 0; i < opened_windows_count; i++)
+    OpenedWindowSet *old = atomic_exchange(&opened_windows, set);
+    if (old != NULL)
     {
-        if (opened_windows[i] == window)
+        if (retired_window_set_count == MAX_RETIRED_WINDOW_SETS)
         {
-            opened_windows[i] = opened_windows[opened_windows_count - 1];
-            opened_windows_count--;
-            break;
+            ReclaimOpenedWindowSets(1);
         }
+        retired_window_sets[retired_window_set_count++] = old;
     }
-    glps_thread_mutex_unlock(&window_list_mutex);
+    ReclaimOpenedWindowSets(0);
 }
-int IsWindowInOpenedWindows(Window window)
+static int FindOpenedWindowSlot(const OpenedWindowSet *set, Window window)
 {
-    int found = 0;
-    int i = 0;
-    glps_thread_mutex_lock(&window_list_mutex);
-    found = 0;
-    for (i = 0; i < opened_windows_count; i++)
+    int low = 0;
+    int high = (set != NULL) ? set->count : 0;
+    while (low < high)
     {
-        if (opened_windows[i] == window)
+        int mid = low + (high - low) / 2;
+        if (set->windows[mid] < window)
         {
-            found = 1;
-            break;
+            low = mid + 1;
         }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+void AddToOpenedWindows(Window window)
+{
+    const OpenedWindowSet *current = atomic_load(&opened_windows);
+    OpenedWindowSet *next = NULL;
+    int count = (current != NULL) ? current->count : 0;
+    int slot = FindOpenedWindowSlot(current, window);
+    if ((slot < count) && (current->windows[slot] == window))
+    {
+        return;
+    }
+    next = malloc(sizeof(OpenedWindowSet) + sizeof(Window) * (size_t)(count + 1));
+    if (next == NULL)
+    {
+        LogError("AddToOpenedWindows: Failed to allocate opened window set");
+        return;
     }
-    glps_thread_mutex_unlock(&window_list_mutex);
+    if (slot > 0)
+    {
+        memcpy(next->windows, current->windows, sizeof(Window) * (size_t)slot);
+    }
+    next->windows[slot] = window;
+    if (count > slot)
+    {
+        memcpy(&next->windows[slot + 1], &current->windows[slot], sizeof(Window) * (size_t)(count - slot));
+    }
+    next->count = count + 1;
+    PublishOpenedWindows(next);
+}
+void RemoveFromOpenedWindows(Window window)
+{
+    const OpenedWindowSet *current = atomic_load(&opened_windows);
+    OpenedWindowSet *next = NULL;
+    int count = (current != NULL) ? current->count : 0;
+    int slot = FindOpenedWindowSlot(current, window);
+    if ((slot == count) || (current->windows[slot] != window))
+    {
+        return;
+    }
+    next = malloc(sizeof(OpenedWindowSet) + sizeof(Window) * (size_t)((count > 1) ? count - 1 : 1));
+    if (next == NULL)
+    {
+        LogError("RemoveFromOpenedWindows: Failed to allocate opened window set");
+        return;
+    }
+    memcpy(next->windows, current->windows, sizeof(Window) * (size_t)slot);
+    memcpy(&next->windows[slot], &current->windows[slot + 1], sizeof(Window) * (size_t)(count - slot - 1));
+    next->count = count - 1;
+    PublishOpenedWindows(next);
+}
+int IsWindowInOpenedWindows(Window window)
+{
+    const OpenedWindowSet *set = AcquireOpenedWindows();
+    int slot = FindOpenedWindowSlot(set, window);
+    int found = ((set != NULL) && (slot < set->count) && (set->windows[slot] == window)) ? 1 : 0;
+    ReleaseOpenedWindows();
     return found;
 }
+void FreeOpenedWindows(void)
+{
+    PublishOpenedWindows(NULL);
+    ReclaimOpenedWindowSets(1);
+}
 void InitializeAtoms(Display *display)
 {
     if (display == NULL)
@@ -669,49 +867,83 @@ void InitializeAtoms(Display *display)
     atoms.gooey_desktop_app = XInternAtom(display, "GOOEY_DESKTOP_APP", False);
     atoms.net_wm_window_opacity = XInternAtom(display, "_NET_WM_WINDOW_OPACITY", False);
 }
-int InitializeMultiMonitor(GooeyShellState *state)
+static int GetModeRefreshRate(XRRScreenResources *resources, RRMode mode)
 {
-    int event_base = 0;
-    int error_base = 0;
-    if (ValidateWindowState(state) == 0)
-    {
-        return 0;
-    }
-    if (XRRQueryExtension(state->display, &event_base, &error_base) == 0)
+    for (int i = 0; i < resources->nmode; i++)
     {
-        state->monitor_info.monitors = malloc(sizeof(Monitor));
-        if (state->monitor_info.monitors == NULL)
+        XRRModeInfo *info = &resources->modes[i];
+        double v_total = 0.0;
+        if (info->id != mode)
+        {
+            continue;
+        }
+        v_total = (double)info->vTotal;
+        if ((info->modeFlags & RR_DoubleScan) != 0)
+        {
+            v_total *= 2.0;
+        }
+        if ((info->modeFlags & RR_Interlace) != 0)
+        {
+            v_total /= 2.0;
+        }
+        if ((info->hTotal == 0U) || (v_total <= 0.0))
         {
-            LogError("InitializeMultiMonitor: Failed to allocate monitor info");
             return 0;
         }
-        state->monitor_info.num_monitors = 1;
-        state->monitor_info.primary_monitor = 0;
-        state->monitor_info.monitors[0].x = 0;
-        state->monitor_info.monitors[0].y = 0;
-        state->monitor_info.monitors[0].width = DisplayWidth(state->display, state->screen);
-        state->monitor_info.monitors[0].height = DisplayHeight(state->display, state->screen);
-        state->monitor_info.monitors[0].number = 0;
-        return 1;
+        return (int)(((double)info->dotClock / ((double)info->hTotal * v_total)) + 0.5);
     }
-    XRRScreenResources *resources = XRRGetScreenResources(state->display, state->root);
+    return 0;
+}
+static Monitor *CreateFallbackMonitor(GooeyShellState *state, int *count)
+{
+    Monitor *monitors = calloc(1, sizeof(Monitor));
+    if (monitors == NULL)
+    {
+        LogError("CreateFallbackMonitor: Failed to allocate fallback monitor");
+        return NULL;
+    }
+    monitors[0].x = 0;
+    monitors[0].y = 0;
+    monitors[0].width = DisplayWidth(state->display, state->screen);
+    monitors[0].height = DisplayHeight(state->display, state->screen);
+    monitors[0].number = 0;
+    monitors[0].refresh_rate = 0;
+    monitors[0].crtc = None;
+    *count = 1;
+    return monitors;
+}
+Monitor *QueryMonitors(GooeyShellState *state, int use_current, int *count)
+{
+    XRRScreenResources *resources = NULL;
+    Monitor *monitors = NULL;
+    int num_monitors = 0;
+    if ((ValidateWindowState(state) == 0) || (count == NULL))
+    {
+        return NULL;
+    }
+    *count = 0;
+    if (state->has_randr == 0)
+    {
+        return CreateFallbackMonitor(state, count);
+    }
+    resources = (use_current != 0) ? XRRGetScreenResourcesCurrent(state->display, state->root)
+                                   : XRRGetScreenResources(state->display, state->root);
     if (resources == NULL)
     {
-        LogError("InitializeMultiMonitor: Failed to get screen resources");
-        return 0;
+        LogError("QueryMonitors: Failed to get screen resources");
+        return NULL;
     }
-    state->monitor_info.monitors = malloc(sizeof(Monitor) * (size_t)resources->noutput);
-    if (state->monitor_info.monitors == NULL)
+    monitors = calloc((size_t)((resources->noutput > 0) ? resources->noutput : 1), sizeof(Monitor));
+    if (monitors == NULL)
     {
         XRRFreeScreenResources(resources);
-        LogError("InitializeMultiMonitor: Failed to allocate monitors");
-        return 0;
+        LogError("QueryMonitors: Failed to allocate monitors");
+        return NULL;
     }
-    state->monitor_info.num_monitors = 0;
-    state->monitor_info.primary_monitor = 0;
     for (int i = 0; i < resources->noutput; i++)
     {
         XRROutputInfo *output_info = XRRGetOutputInfo(state->display, resources, resources->outputs[i]);
+        int duplicate = 0;
         if ((output_info == NULL) || (output_info->connection != RR_Connected))
         {
             if (output_info != NULL)
@@ -720,18 +952,28 @@ int InitializeMultiMonitor(GooeyShellState *state)
             }
             continue;
         }
-        if (output_info->crtc != 0)
+        for (int j = 0; j < num_monitors; j++)
+        {
+            if (monitors[j].crtc == output_info->crtc)
+            {
+                duplicate = 1;
+                break;
+            }
+        }
+        if ((output_info->crtc != 0) && (duplicate == 0))
         {
             XRRCrtcInfo *crtc_info = XRRGetCrtcInfo(state->display, resources, output_info->crtc);
             if ((crtc_info != NULL) && (crtc_info->width > 0) && (crtc_info->height > 0))
             {
-                Monitor *mon = &state->monitor_info.monitors[state->monitor_info.num_monitors];
+                Monitor *mon = &monitors[num_monitors];
                 mon->x = crtc_info->x;
                 mon->y = crtc_info->y;
                 mon->width = crtc_info->width;
                 mon->height = crtc_info->height;
-                mon->number = state->monitor_info.num_monitors;
-                state->monitor_info.num_monitors++;
+                mon->number = num_monitors;
+                mon->refresh_rate = GetModeRefreshRate(resources, crtc_info->mode);
+                mon->crtc = output_info->crtc;
+                num_monitors++;
             }
             if (crtc_info != NULL)
             {
@@ -741,22 +983,35 @@ int InitializeMultiMonitor(GooeyShellState *state)
         XRRFreeOutputInfo(output_info);
     }
     XRRFreeScreenResources(resources);
-    if (state->monitor_info.num_monitors == 0)
+    if (num_monitors == 0)
     {
-        free(state->monitor_info.monitors);
-        state->monitor_info.monitors = malloc(sizeof(Monitor));
-        if (state->monitor_info.monitors == NULL)
-        {
-            LogError("InitializeMultiMonitor: Failed to allocate fallback monitor");
-            return 0;
-        }
-        state->monitor_info.num_monitors = 1;
-        state->monitor_info.primary_monitor = 0;
-        state->monitor_info.monitors[0].x = 0;
-        state->monitor_info.monitors[0].y = 0;
-        state->monitor_info.monitors[0].width = DisplayWidth(state->display, state->screen);
-        state->monitor_info.monitors[0].height = DisplayHeight(state->display, state->screen);
-        state->monitor_info.monitors[0].number = 0;
+        free(monitors);
+        return CreateFallbackMonitor(state, count);
+    }
+    *count = num_monitors;
+    return monitors;
+}
+int InitializeMultiMonitor(GooeyShellState *state)
+{
+    int error_base = 0;
+    int count = 0;
+    if (ValidateWindowState(state) == 0)
+    {
+        return 0;
+    }
+    state->has_randr = (XRRQueryExtension(state->display, &state->randr_event_base, &error_base) != 0) ? 1 : 0;
+    state->monitor_info.monitors = QueryMonitors(state, 0, &count);
+    if (state->monitor_info.monitors == NULL)
+    {
+        LogError("InitializeMultiMonitor: Failed to query monitors");
+        return 0;
+    }
+    state->monitor_info.num_monitors = count;
+    state->monitor_info.primary_monitor = 0;
+    if (state->has_randr != 0)
+    {
+        XRRSelectInput(state->display, state->root,
+                       RRScreenChangeNotifyMask | RRCrtcChangeNotifyMask | RROutputChangeNotifyMask);
     }
     return 1;
 }
@@ -772,6 +1027,7 @@ void FreeMultiMonitor(GooeyShellState *state)
         state->monitor_info.monitors = NULL;
     }
     state->monitor_info.num_monitors = 0;
+    StopDesktopApps(state);
 }
 int GetMonitorForWindow(GooeyShellState *state, int x, int y, int width, int height)
 {
@@ -835,49 +1091,7 @@ int GetCurrentMonitor(GooeyShellState *state)
     }
     return 0;
 }
-void LaunchDesktopAppsForAllMonitors(GooeyShellState *state)
-{
-    int i = 0;
-    const char *desktop_app_cmd = "/usr/local/bin/gooeyde_desktop";
-    if ((state == NULL) || (state->monitor_info.monitors == NULL) || (state->monitor_info.num_monitors == 0))
-    {
-        return;
-    }
-    LogInfo("LaunchDesktopAppsForAllMonitors: Launching desktop apps for %d monitors",
-            state->monitor_info.num_monitors);
-    for (i = 0; i < state->monitor_info.num_monitors; i++)
-    {
-        pid_t pid = fork();
-        if (pid == 0)
-        {
-            setenv("GOOEY_DESKTOP_APP", "1", 1);
-            setenv("DISPLAY", DisplayString(state->display), 1);
-            char monitor_env[32];
-            (void)snprintf(monitor_env, sizeof(monitor_env), "%d", i);
-            setenv("GOOEY_MONITOR", monitor_env, 1);
-            int max_fd = sysconf(_SC_OPEN_MAX);
-            if (max_fd == -1)
-            {
-                max_fd = 1024;
-            }
-            for (int fd = 3; fd < max_fd; fd++)
-            {
-                (void)close(fd);
-            }
-            execlp("sh", "sh", "-c", desktop_app_cmd, NULL);
-            _exit(1);
-        }
-        else if (pid > 0)
-        {
-            LogInfo("LaunchDesktopAppsForAllMonitors: Launched desktop app for monitor %d (PID: %d)", i, pid);
-        }
-        else
-        {
-            LogError("LaunchDesktopAppsForAllMonitors: Failed to fork for desktop app on monitor %d", i);
-        }
-    }
-}
-void MoveWindowToMonitor(GooeyShellState *state, WindowNode *node, int monitor_number)
+void MoveWindowToMonitor(GooeyShellState *state, WindowNode *node, int monitor_number)
 {
     int old_monitor = 0;
     int bar_height = 0;
@@ -896,6 +1110,7 @@ void MoveWindowToMonitor(GooeyShellState *state, WindowNode *node, int monitor_n
     old_monitor = node->monitor_number;
     bar_height = (monitor_number == 0) ? BAR_HEIGHT : 0;
     node->monitor_number = monitor_number;
+    state->snapshot_dirty = 1;
     if (monitor_number < state->monitor_info.num_monitors)
     {
         mon = &state->monitor_info.monitors[monitor_number];
@@ -926,9 +1141,9 @@ void MoveWindowToMonitor(GooeyShellState *state, WindowNode *node, int monitor_n
         {
             if ((old_monitor >= 0) && (old_monitor < state->monitor_info.num_monitors))
             {
-                ArrangeWindowsTilingOnMonitor(state, ws, old_monitor);
+                ArrangeWindowsOnMonitor(state, ws, old_monitor);
             }
-            ArrangeWindowsTilingOnMonitor(state, ws, monitor_number);
+            ArrangeWindowsOnMonitor(state, ws, monitor_number);
         }
     }
 }
@@ -950,14 +1165,16 @@ void InitializeWorkspaces(GooeyShellState *state)
     state->workspaces->windows = NULL;
     state->workspaces->next = NULL;
     state->workspaces->master_ratio = 0.6f;
-    state->workspaces->stack_ratios = NULL;
-    state->workspaces->stack_ratios_count = 0;
     state->workspaces->monitor_tiling_roots_count = state->monitor_info.num_monitors;
     state->workspaces->monitor_tiling_roots = calloc((size_t)state->monitor_info.num_monitors,
                                                      sizeof(TilingNode *));
-    if (state->workspaces->monitor_tiling_roots == NULL)
+    state->workspaces->monitor_stack_ratios = calloc((size_t)state->monitor_info.num_monitors,
+                                                     sizeof(StackRatios));
+    if ((state->workspaces->monitor_tiling_roots == NULL) || (state->workspaces->monitor_stack_ratios == NULL))
     {
         LogError("InitializeWorkspaces: Failed to allocate monitor tiling roots");
+        free(state->workspaces->monitor_tiling_roots);
+        free(state->workspaces->monitor_stack_ratios);
         free(state->workspaces);
         state->workspaces = NULL;
         return;
@@ -1028,14 +1245,16 @@ Workspace *CreateWorkspace(GooeyShellState *state, int workspace_number)
     new_ws->windows = NULL;
     new_ws->next = NULL;
     new_ws->master_ratio = 0.6f;
-    new_ws->stack_ratios = NULL;
-    new_ws->stack_ratios_count = 0;
     new_ws->monitor_tiling_roots_count = state->monitor_info.num_monitors;
     new_ws->monitor_tiling_roots = calloc((size_t)state->monitor_info.num_monitors,
                                           sizeof(TilingNode *));
-    if (new_ws->monitor_tiling_roots == NULL)
+    new_ws->monitor_stack_ratios = calloc((size_t)state->monitor_info.num_monitors,
+                                          sizeof(StackRatios));
+    if ((new_ws->monitor_tiling_roots == NULL) || (new_ws->monitor_stack_ratios == NULL))
     {
         LogError("CreateWorkspace: Failed to allocate monitor tiling roots for new workspace");
+        free(new_ws->monitor_tiling_roots);
+        free(new_ws->monitor_stack_ratios);
         free(new_ws);
         return NULL;
     }
@@ -1071,6 +1290,7 @@ void AddWindowToWorkspace(GooeyShellState *state, WindowNode *node, int workspac
         }
     }
     node->workspace = workspace;
+    state->snapshot_dirty = 1;
     node->next = ws->windows;
     if (ws->windows != NULL)
     {
@@ -1151,7 +1371,7 @@ void FreeWindowNode(WindowNode *node)
         return;
     }
     free(node->title);
-    free(node);
+    PoolRelease(SHELL_POOL_WINDOW_NODE, node);
 }
 char *StrDup(const char *str)
 {
@@ -1170,224 +1390,83 @@ char *StrDup(const char *str)
 }
 void UpdateWindowGeometry(GooeyShellState *state, WindowNode *node)
 {
-    int frame_width = 0;
-    int frame_height = 0;
-    int client_x = 0;
-    int client_y = 0;
-    Monitor *mon = NULL;
     if ((ValidateWindowState(state) == 0) || (node == NULL))
     {
         return;
     }
-    XSetWindowBorder(state->display, node->frame, state->border_color);
-    if ((node->is_desktop_app != 0) || (node->is_fullscreen_app != 0))
-    {
-        if (node->monitor_number < state->monitor_info.num_monitors)
-        {
-            mon = &state->monitor_info.monitors[node->monitor_number];
-            XMoveResizeWindow(state->display, node->frame, mon->x, mon->y, mon->width, mon->height);
-            XMoveResizeWindow(state->display, node->client, 0, 0, mon->width, mon->height);
-        }
-    }
-    else
-    {
-        frame_width = node->width + 2 * BORDER_WIDTH;
-        frame_height = node->height + ((node->is_titlebar_disabled != 0) ? 0 : TITLE_BAR_HEIGHT) + 2 * BORDER_WIDTH;
-        XMoveResizeWindow(state->display, node->frame, node->x, node->y, frame_width, frame_height);
-        client_x = BORDER_WIDTH;
-        client_y = (node->is_titlebar_disabled != 0) ? BORDER_WIDTH : TITLE_BAR_HEIGHT + BORDER_WIDTH;
-        XMoveWindow(state->display, node->client, client_x, client_y);
-        XResizeWindow(state->display, node->client, node->width, node->height);
-        if (node->is_titlebar_disabled == 0)
-        {
-            DrawTitleBar(state, node);
-        }
-    }
+    QueueWindowGeometry(state, node);
 }
-int IsDesktopAppByProperties(GooeyShellState *state, Window client)
+int MatchTitleAppType(const char *title, int *is_desktop, int *is_fullscreen, int *stay_on_top)
 {
-    Atom actual_type = 0;
-    int actual_format = 0;
-    unsigned long nitems = 0;
-    unsigned long bytes_after = 0;
-    unsigned char *prop_data = NULL;
-    int result = 0;
-    if (ValidateWindowState(state) == 0)
-    {
-        return 0;
-    }
-    if ((atoms.gooey_desktop_app != None) &&
-        (XGetWindowProperty(state->display, client, atoms.gooey_desktop_app, 0, 1,
-                            False, XA_STRING, &actual_type, &actual_format,
-                            &nitems, &bytes_after, &prop_data) == Success) &&
-        (prop_data != NULL))
-    {
-        SafeXFree(prop_data);
-        result = 1;
-    }
-    if ((result == 0) &&
-        (XGetWindowProperty(state->display, client, atoms.net_wm_window_type, 0, 1,
-                            False, XA_ATOM, &actual_type, &actual_format,
-                            &nitems, &bytes_after, &prop_data) == Success) &&
-        (prop_data != NULL))
+    char lower_title[256];
+    int len = strlen(title);
+    int i = 0;
+    for (i = 0; (i < len) && (i < 255); i++)
     {
-        Atom window_type = ((Atom *)prop_data)[0];
-        SafeXFree(prop_data);
-        if (window_type == atoms.net_wm_window_type_desktop)
-        {
-            result = 1;
-        }
+        lower_title[i] = (char)tolower(title[i]);
     }
-    return result;
-}
-int IsFullscreenAppByProperties(GooeyShellState *state, Window client, int *stay_on_top)
-{
-    Atom actual_type = 0;
-    int actual_format = 0;
-    unsigned long nitems = 0;
-    unsigned long bytes_after = 0;
-    unsigned char *prop_data = NULL;
-    int result = 0;
-    if (ValidateWindowState(state) == 0)
+    lower_title[(len < 255) ? len : 255] = '\0';
+    if ((strstr(lower_title, "desktop") != NULL) ||
+        (strstr(lower_title, "wallpaper") != NULL) ||
+        (strstr(lower_title, "background") != NULL))
     {
-        return 0;
+        *is_desktop = 1;
+        return 1;
     }
-    *stay_on_top = 0;
-    if ((atoms.gooey_fullscreen_app != None) &&
-        (XGetWindowProperty(state->display, client, atoms.gooey_fullscreen_app, 0, 1,
-                            False, XA_STRING, &actual_type, &actual_format,
-                            &nitems, &bytes_after, &prop_data) == Success) &&
-        (prop_data != NULL))
+    else if ((strstr(lower_title, "app menu") != NULL) ||
+             (strstr(lower_title, "application menu") != NULL) ||
+             (strstr(lower_title, "gooeyde_appmenu") != NULL) ||
+             (strstr(lower_title, "launcher") != NULL) ||
+             (strstr(lower_title, "menu") != NULL))
     {
-        SafeXFree(prop_data);
-        if ((atoms.gooey_stay_on_top != None) &&
-            (XGetWindowProperty(state->display, client, atoms.gooey_stay_on_top, 0, 1,
-                                False, XA_STRING, &actual_type, &actual_format,
-                                &nitems, &bytes_after, &prop_data) == Success) &&
-            (prop_data != NULL))
-        {
-            *stay_on_top = 1;
-            SafeXFree(prop_data);
-        }
-        result = 1;
+        *is_fullscreen = 1;
+        *stay_on_top = 1;
+        return 1;
     }
-    if ((result == 0) &&
-        (XGetWindowProperty(state->display, client, atoms.net_wm_window_type, 0, 1,
-                            False, XA_ATOM, &actual_type, &actual_format,
-                            &nitems, &bytes_after, &prop_data) == Success) &&
-        (prop_data != NULL))
+    else if ((strstr(lower_title, "dock") != NULL) ||
+             (strstr(lower_title, "taskbar") != NULL) ||
+             (strstr(lower_title, "panel") != NULL) ||
+             (strstr(lower_title, "toolbar") != NULL))
     {
-        Atom window_type = ((Atom *)prop_data)[0];
-        SafeXFree(prop_data);
-        if ((window_type == atoms.net_wm_window_type_dock) ||
-            (window_type == atoms.net_wm_window_type_toolbar) ||
-            (window_type == atoms.net_wm_window_type_menu))
-        {
-            *stay_on_top = 1;
-            result = 1;
-        }
+        *is_fullscreen = 1;
+        *stay_on_top = 1;
+        return 1;
     }
-    return result;
+    return 0;
 }
-int DetectAppTypeByTitleClass(GooeyShellState *state, Window client, int *is_desktop, int *is_fullscreen, int *stay_on_top)
+int MatchClassAppType(const char *res_name, int *is_desktop, int *is_fullscreen, int *stay_on_top)
 {
-    XTextProperty text_prop;
-    XClassHint class_hint;
-    int detected = 0;
-    if (ValidateWindowState(state) == 0)
+    char lower_class[256];
+    int len = strlen(res_name);
+    int i = 0;
+    for (i = 0; (i < len) && (i < 255); i++)
     {
-        return 0;
+        lower_class[i] = (char)tolower(res_name[i]);
     }
-    *is_desktop = 0;
-    *is_fullscreen = 0;
-    *stay_on_top = 0;
-    if ((XGetWMName(state->display, client, &text_prop) != 0) && (text_prop.value != NULL))
+    lower_class[(len < 255) ? len : 255] = '\0';
+    if ((strstr(lower_class, "desktop") != NULL) ||
+        (strstr(lower_class, "background") != NULL))
     {
-        char *title = (char *)text_prop.value;
-        char lower_title[256];
-        int len = strlen(title);
-        int i = 0;
-        for (i = 0; (i < len) && (i < 255); i++)
-        {
-            lower_title[i] = (char)tolower(title[i]);
-        }
-        lower_title[(len < 255) ? len : 255] = '\0';
-        if ((strstr(lower_title, "desktop") != NULL) ||
-            (strstr(lower_title, "wallpaper") != NULL) ||
-            (strstr(lower_title, "background") != NULL))
-        {
-            *is_desktop = 1;
-            SafeXFree(text_prop.value);
-            return 1;
-        }
-       
-        else if ((strstr(lower_title, "app menu") != NULL) ||
-                 (strstr(lower_title, "application menu") != NULL) ||
-                 (strstr(lower_title, "gooeyde_appmenu") != NULL) ||
-                 (strstr(lower_title, "launcher") != NULL) ||
-                 (strstr(lower_title, "menu") != NULL))
-        {
-            *is_fullscreen = 1;
-            *stay_on_top = 1;
-            SafeXFree(text_prop.value);
-            return 1;
-        }
-        else if ((strstr(lower_title, "dock") != NULL) ||
-                 (strstr(lower_title, "taskbar") != NULL) ||
-                 (strstr(lower_title, "panel") != NULL) ||
-                 (strstr(lower_title, "toolbar") != NULL))
-        {
-            *is_fullscreen = 1;
-            *stay_on_top = 1;
-            SafeXFree(text_prop.value);
-            return 1;
-        }
-        SafeXFree(text_prop.value);
+        *is_desktop = 1;
+        return 1;
     }
-    if (XGetClassHint(state->display, client, &class_hint) != 0)
+    else if ((strstr(lower_class, "gooeyde_appmenu") != NULL) ||
+             (strstr(lower_class, "appmenu") != NULL) ||
+             (strstr(lower_class, "launcher") != NULL) ||
+             (strstr(lower_class, "menu") != NULL))
     {
-        detected = 0;
-        if (class_hint.res_name != NULL)
-        {
-            char lower_class[256];
-            int len = strlen(class_hint.res_name);
-            int i = 0;
-            for (i = 0; (i < len) && (i < 255); i++)
-            {
-                lower_class[i] = (char)tolower(class_hint.res_name[i]);
-            }
-            lower_class[(len < 255) ? len : 255] = '\0';
-            if ((strstr(lower_class, "desktop") != NULL) ||
-                (strstr(lower_class, "background") != NULL))
-            {
-                *is_desktop = 1;
-                detected = 1;
-            }
-            else if ((strstr(lower_class, "gooeyde_appmenu") != NULL) ||
-                     (strstr(lower_class, "appmenu") != NULL) ||
-                     (strstr(lower_class, "launcher") != NULL) ||
-                     (strstr(lower_class, "menu") != NULL))
-            {
-                *is_fullscreen = 1;
-                *stay_on_top = 1;
-                detected = 1;
-            }
-            else if ((strstr(lower_class, "dock") != NULL) ||
-                     (strstr(lower_class, "taskbar") != NULL) ||
-                     (strstr(lower_class, "panel") != NULL) ||
-                     (strstr(lower_class, "toolbar") != NULL))
-            {
-                *is_fullscreen = 1;
-                *stay_on_top = 1;
-                detected = 1;
-            }
-        }
-        SafeXFree(class_hint.res_name);
-        SafeXFree(class_hint.res_class);
-        if (detected != 0)
-        {
-            return 1;
-        }
+        *is_fullscreen = 1;
+        *stay_on_top = 1;
+        return 1;
+    }
+    else if ((strstr(lower_class, "dock") != NULL) ||
+             (strstr(lower_class, "taskbar") != NULL) ||
+             (strstr(lower_class, "panel") != NULL) ||
+             (strstr(lower_class, "toolbar") != NULL))
+    {
+        *is_fullscreen = 1;
+        *stay_on_top = 1;
+        return 1;
     }
     return 0;
 }
@@ -1417,6 +1496,7 @@ void SetupDesktopApp(GooeyShellState *state, WindowNode *node)
         XSetWindowBorderWidth(state->display, node->frame, 0);
         XMoveResizeWindow(state->display, node->frame, mon->x, mon->y, mon->width, mon->height);
         XMoveResizeWindow(state->display, node->client, 0, 0, mon->width, mon->height);
+        InvalidateWindowGeometry(node);
     }
     if ((atoms.net_wm_window_type != None) && (atoms.net_wm_window_type_desktop != None))
     {
@@ -1434,8 +1514,9 @@ void SetupDesktopApp(GooeyShellState *state, WindowNode *node)
         SetWindowStateProperties(state, node->client, states, 4);
         SetWindowStateProperties(state, node->frame, states, 4);
     }
-    XLowerWindow(state->display, node->frame);
+    LowerWindowNode(state, node);
     state->desktop_app_window = node->frame;
+    AdoptDesktopAppWindow(state, node);
 }
 void SetupFullscreenApp(GooeyShellState *state, WindowNode *node, int stay_on_top)
 {
@@ -1455,6 +1536,7 @@ void SetupFullscreenApp(GooeyShellState *state, WindowNode *node, int stay_on_to
         XSetWindowBorderWidth(state->display, node->frame, 0);
         XMoveResizeWindow(state->display, node->frame, mon->x, mon->y, mon->width, mon->height);
         XMoveResizeWindow(state->display, node->client, 0, 0, mon->width, mon->height);
+        InvalidateWindowGeometry(node);
     }
     if ((atoms.net_wm_window_type != None) && (atoms.net_wm_window_type_dock != None))
     {
@@ -1472,40 +1554,13 @@ void SetupFullscreenApp(GooeyShellState *state, WindowNode *node, int stay_on_to
         states[4] = atoms.net_wm_state_skip_pager;
         SetWindowStateProperties(state, node->client, states, 5);
         SetWindowStateProperties(state, node->frame, states, 5);
-        XRaiseWindow(state->display, node->frame);
+        RaiseWindowNode(state, node);
     }
     state->fullscreen_app_window = node->frame;
     FocusRootWindow(state);
 }
-void EnsureDesktopAppStaysInBackground(GooeyShellState *state)
-{
-    if (ValidateWindowState(state) == 0)
-    {
-        return;
-    }
-    if (state->desktop_app_window != None)
-    {
-        XLowerWindow(state->display, state->desktop_app_window);
-    }
-}
-void EnsureFullscreenAppStaysOnTop(GooeyShellState *state)
-{
-    if (ValidateWindowState(state) == 0)
-    {
-        return;
-    }
-    if (state->fullscreen_app_window != None)
-    {
-        WindowNode *fullscreen_node = FindWindowNodeByFrame(state, state->fullscreen_app_window);
-        if ((fullscreen_node != NULL) && (fullscreen_node->stay_on_top != 0))
-        {
-            XRaiseWindow(state->display, state->fullscreen_app_window);
-        }
-    }
-}
-int CreateFrameWindow(GooeyShellState *state, Window client, int is_desktop_app)
+int CreateFrameWindow(GooeyShellState *state, Window client, int is_desktop_app, const WindowProbe *probe)
 {
-    XWindowAttributes attr;
     int client_width = 0;
     int client_height = 0;
     int frame_width = 0;
@@ -1516,7 +1571,6 @@ int CreateFrameWindow(GooeyShellState *state, Window client, int is_desktop_app)
     Monitor *mon = NULL;
     int client_x = 0;
     int client_y = 0;
-    XTextProperty text_prop;
     Atom protocols[1];
     if (ValidateWindowState(state) == 0)
     {
@@ -1526,12 +1580,12 @@ int CreateFrameWindow(GooeyShellState *state, Window client, int is_desktop_app)
     {
         return 0;
     }
-    if (XGetWindowAttributes(state->display, client, &attr) == 0)
+    if ((probe == NULL) || (probe->valid == 0))
     {
         return 0;
     }
-    client_width = (attr.width > 0) ? attr.width : DEFAULT_WIDTH;
-    client_height = (attr.height > 0) ? attr.height : DEFAULT_HEIGHT;
+    client_width = (probe->width > 0) ? probe->width : DEFAULT_WIDTH;
+    client_height = (probe->height > 0) ? probe->height : DEFAULT_HEIGHT;
     if (is_desktop_app != 0)
     {
         monitor_number = 0;
@@ -1547,7 +1601,7 @@ int CreateFrameWindow(GooeyShellState *state, Window client, int is_desktop_app)
     }
     else
     {
-        monitor_number = GetMonitorForWindow(state, attr.x, attr.y, client_width, client_height);
+        monitor_number = GetMonitorForWindow(state, probe->x, probe->y, client_width, client_height);
         int bar_height = (monitor_number == 0) ? BAR_HEIGHT : 0;
         if (monitor_number < state->monitor_info.num_monitors)
         {
@@ -1565,7 +1619,7 @@ int CreateFrameWindow(GooeyShellState *state, Window client, int is_desktop_app)
     {
         return 0;
     }
-    new_node = calloc(1, sizeof(WindowNode));
+    new_node = PoolAllocate(SHELL_POOL_WINDOW_NODE);
     if (new_node == NULL)
     {
         XDestroyWindow(state->display, frame);
@@ -1598,8 +1652,8 @@ int CreateFrameWindow(GooeyShellState *state, Window client, int is_desktop_app)
     }
     else
     {
-        new_node->x = attr.x;
-        new_node->y = attr.y;
+        new_node->x = probe->x;
+        new_node->y = probe->y;
         new_node->width = client_width;
         new_node->height = client_height;
     }
@@ -1614,12 +1668,17 @@ int CreateFrameWindow(GooeyShellState *state, Window client, int is_desktop_app)
         state->window_list->prev = new_node;
     }
     state->window_list = new_node;
-    if ((XGetWMName(state->display, client, &text_prop) != 0) && (text_prop.value != NULL))
+    (void)WindowIndexInsert(state, frame, new_node);
+    (void)WindowIndexInsert(state, client, new_node);
+    if (probe->title != NULL)
     {
         free(new_node->title);
-        new_node->title = StrDup((char *)text_prop.value);
-        SafeXFree(text_prop.value);
+        new_node->title = StrDup(probe->title);
     }
+    new_node->min_width = probe->min_width;
+    new_node->min_height = probe->min_height;
+    new_node->max_width = probe->max_width;
+    new_node->max_height = probe->max_height;
     if (is_desktop_app != 0)
     {
         XSelectInput(state->display, frame, ExposureMask | StructureNotifyMask);
@@ -1641,7 +1700,6 @@ int CreateFrameWindow(GooeyShellState *state, Window client, int is_desktop_app)
             XReparentWindow(state->display, client, frame, client_x, client_y);
         }
         XDefineCursor(state->display, frame, state->custom_cursor);
-        EnsureDesktopAppStaysInBackground(state);
     }
     if ((atoms.wm_protocols != None) && (atoms.wm_delete_window != None))
     {
@@ -1649,13 +1707,13 @@ int CreateFrameWindow(GooeyShellState *state, Window client, int is_desktop_app)
         XSetWMProtocols(state->display, client, protocols, 1);
     }
     AddToOpenedWindows(frame);
-    SendWindowStateThroughDBus(state, frame, "opened");
+    QueueWindowStateSignal(state, frame, "opened");
     XMapWindow(state->display, frame);
     XMapWindow(state->display, client);
     if (is_desktop_app == 0)
     {
         state->focused_window = frame;
-        XRaiseWindow(state->display, frame);
+        RaiseWindowNode(state, new_node);
         DrawTitleBar(state, new_node);
         Workspace *ws = GetCurrentWorkspace(state);
         if (ws != NULL)
@@ -1672,7 +1730,7 @@ int CreateFrameWindow(GooeyShellState *state, Window client, int is_desktop_app)
                 }
                 node = node->next;
             }
-            LogInfo("CreateFrameWindow: Tiling %d windows after new window creation", tiled_count);
+            LogDebug("CreateFrameWindow: Tiling %d windows after new window creation", tiled_count);
             TileWindowsOnWorkspace(state, ws);
         }
     }
@@ -1680,16 +1738,13 @@ int CreateFrameWindow(GooeyShellState *state, Window client, int is_desktop_app)
     {
         FocusWindow(state, new_node);
     }
-    RegrabKeys(state);
     return 1;
 }
-int CreateFullscreenAppWindow(GooeyShellState *state, Window client, int stay_on_top)
+int CreateFullscreenAppWindow(GooeyShellState *state, Window client, int stay_on_top, const WindowProbe *probe)
 {
-    XWindowAttributes attr;
     Window frame = None;
     WindowNode *new_node = NULL;
     Monitor *mon = NULL;
-    XTextProperty text_prop;
     Atom protocols[1];
     if (ValidateWindowState(state) == 0)
     {
@@ -1699,11 +1754,11 @@ int CreateFullscreenAppWindow(GooeyShellState *state, Window client, int stay_on
     {
         return 0;
     }
-    if (XGetWindowAttributes(state->display, client, &attr) == 0)
+    if ((probe == NULL) || (probe->valid == 0))
     {
         return 0;
     }
-    int monitor_number = GetMonitorForWindow(state, attr.x, attr.y, attr.width, attr.height);
+    int monitor_number = GetMonitorForWindow(state, probe->x, probe->y, probe->width, probe->height);
     if (monitor_number < state->monitor_info.num_monitors)
     {
         mon = &state->monitor_info.monitors[monitor_number];
@@ -1715,7 +1770,7 @@ int CreateFullscreenAppWindow(GooeyShellState *state, Window client, int stay_on
     {
         return 0;
     }
-    new_node = calloc(1, sizeof(WindowNode));
+    new_node = PoolAllocate(SHELL_POOL_WINDOW_NODE);
     if (new_node == NULL)
     {
         XDestroyWindow(state->display, frame);
@@ -1751,12 +1806,17 @@ int CreateFullscreenAppWindow(GooeyShellState *state, Window client, int stay_on
         state->window_list->prev = new_node;
     }
     state->window_list = new_node;
-    if ((XGetWMName(state->display, client, &text_prop) != 0) && (text_prop.value != NULL))
+    (void)WindowIndexInsert(state, frame, new_node);
+    (void)WindowIndexInsert(state, client, new_node);
+    if (probe->title != NULL)
     {
         free(new_node->title);
-        new_node->title = StrDup((char *)text_prop.value);
-        SafeXFree(text_prop.value);
+        new_node->title = StrDup(probe->title);
     }
+    new_node->min_width = probe->min_width;
+    new_node->min_height = probe->min_height;
+    new_node->max_width = probe->max_width;
+    new_node->max_height = probe->max_height;
     XSelectInput(state->display, frame,
                  ExposureMask | ButtonPressMask | ButtonReleaseMask |
                      PointerMotionMask | StructureNotifyMask | EnterWindowMask | LeaveWindowMask);
@@ -1773,7 +1833,7 @@ int CreateFullscreenAppWindow(GooeyShellState *state, Window client, int stay_on
         XSetWMProtocols(state->display, client, protocols, 1);
     }
     AddToOpenedWindows(frame);
-    SendWindowStateThroughDBus(state, frame, "opened");
+    QueueWindowStateSignal(state, frame, "opened");
     XMapWindow(state->display, frame);
     XMapWindow(state->display, client);
     SetupFullscreenApp(state, new_node, stay_on_top);
@@ -1793,118 +1853,235 @@ void GooeyShell_MarkAsDesktopApp(GooeyShellState *state, Window client)
 }
 void RemoveWindow(GooeyShellState *state, Window client)
 {
-    WindowNode **current = NULL;
     WindowNode *to_free = NULL;
     Workspace *ws = NULL;
     if (ValidateWindowState(state) == 0)
     {
         return;
     }
-    current = &state->window_list;
-    while (*current != NULL)
+    to_free = FindWindowNodeByClient(state, client);
+    if (to_free == NULL)
+    {
+        return;
+    }
+    if (to_free->prev != NULL)
+    {
+        to_free->prev->next = to_free->next;
+    }
+    else if (state->window_list == to_free)
+    {
+        state->window_list = to_free->next;
+    }
+    if (to_free->next != NULL)
+    {
+        to_free->next->prev = to_free->prev;
+    }
+    RemoveWindowFromWorkspace(state, to_free);
+    DetachWindowFromTilingTree(state, to_free);
+    DiscardWindowGeometry(state, to_free);
+    WindowIndexRemove(state, to_free->frame);
+    WindowIndexRemove(state, to_free->client);
+    RemoveFromOpenedWindows(to_free->frame);
+    QueueWindowStateSignal(state, to_free->frame, "closed");
+    if (state->desktop_app_window == to_free->frame)
+    {
+        state->desktop_app_window = None;
+    }
+    ReleaseDesktopAppWindow(state, to_free->frame);
+    if (state->fullscreen_app_window == to_free->frame)
+    {
+        state->fullscreen_app_window = None;
+    }
+    if (state->focused_window == to_free->frame)
+    {
+        FocusRootWindow(state);
+    }
+    FreeTitleBarCache(state, to_free);
+    XDestroyWindow(state->display, to_free->frame);
+    FreeWindowNode(to_free);
+    ws = GetCurrentWorkspace(state);
+    if (ws != NULL)
     {
-        if ((*current)->client == client)
+        int tiled_count = 0;
+        WindowNode *node = ws->windows;
+        while (node != NULL)
         {
-            to_free = *current;
-            *current = (*current)->next;
-            if (*current != NULL)
-            {
-                (*current)->prev = to_free->prev;
-            }
-            RemoveWindowFromWorkspace(state, to_free);
-            RemoveFromOpenedWindows(to_free->frame);
-            SendWindowStateThroughDBus(state, to_free->frame, "closed");
-            if (state->desktop_app_window == to_free->frame)
-            {
-                state->desktop_app_window = None;
-            }
-            if (state->fullscreen_app_window == to_free->frame)
+            if ((node->is_floating == 0) && (node->is_fullscreen == 0) &&
+                (node->is_minimized == 0) && (node->is_desktop_app == 0) &&
+                (node->is_fullscreen_app == 0))
             {
-                state->fullscreen_app_window = None;
+                tiled_count++;
             }
-            if (state->focused_window == to_free->frame)
-            {
-                FocusRootWindow(state);
-            }
-            XDestroyWindow(state->display, to_free->frame);
-            FreeWindowNode(to_free);
-            ws = GetCurrentWorkspace(state);
-            if (ws != NULL)
+            node = node->next;
+        }
+        LogDebug("RemoveWindow: Tiling %d windows after window removal", tiled_count);
+        TileWindowsOnWorkspace(state, ws);
+    }
+}
+static unsigned int WindowIndexSlot(Window key, int capacity)
+{
+    unsigned long long hash = (unsigned long long)key * 0x9E3779B97F4A7C15ULL;
+    return (unsigned int)(hash >> 32) & (unsigned int)(capacity - 1);
+}
+static int WindowIndexResize(GooeyShellState *state, int new_capacity)
+{
+    WindowIndexEntry *old_entries = state->window_index;
+    int old_capacity = state->window_index_capacity;
+    WindowIndexEntry *new_entries = calloc((size_t)new_capacity, sizeof(WindowIndexEntry));
+    int i = 0;
+    if (new_entries == NULL)
+    {
+        LogError("WindowIndexResize: Failed to allocate %d entries", new_capacity);
+        return 0;
+    }
+    for (i = 0; i < old_capacity; i++)
+    {
+        if (old_entries[i].key != None)
+        {
+            unsigned int slot = WindowIndexSlot(old_entries[i].key, new_capacity);
+            while (new_entries[slot].key != None)
             {
-                int tiled_count = 0;
-                WindowNode *node = ws->windows;
-                while (node != NULL)
-                {
-                    if ((node->is_floating == 0) && (node->is_fullscreen == 0) &&
-                        (node->is_minimized == 0) && (node->is_desktop_app == 0) &&
-                        (node->is_fullscreen_app == 0))
-                    {
-                        tiled_count++;
-                    }
-                    node = node->next;
-                }
-                LogInfo("RemoveWindow: Tiling %d windows after window removal", tiled_count);
-                TileWindowsOnWorkspace(state, ws);
+                slot = (slot + 1U) & (unsigned int)(new_capacity - 1);
             }
-            break;
+            new_entries[slot] = old_entries[i];
         }
-        current = &(*current)->next;
     }
-    RegrabKeys(state);
+    free(old_entries);
+    state->window_index = new_entries;
+    state->window_index_capacity = new_capacity;
+    return 1;
 }
-WindowNode *FindWindowNodeByFrame(GooeyShellState *state, Window frame)
+int WindowIndexInsert(GooeyShellState *state, Window key, WindowNode *node)
 {
-    WindowNode *current = NULL;
-    if (ValidateWindowState(state) == 0)
+    unsigned int slot = 0U;
+    if ((state == NULL) || (key == None) || (node == NULL))
+    {
+        return 0;
+    }
+    if ((state->window_index_count + 1) * 10 > state->window_index_capacity * 7)
+    {
+        int new_capacity = (state->window_index_capacity == 0) ? 64 : state->window_index_capacity * 2;
+        if (WindowIndexResize(state, new_capacity) == 0)
+        {
+            return 0;
+        }
+    }
+    slot = WindowIndexSlot(key, state->window_index_capacity);
+    while (state->window_index[slot].key != None)
+    {
+        if (state->window_index[slot].key == key)
+        {
+            state->window_index[slot].node = node;
+            return 1;
+        }
+        slot = (slot + 1U) & (unsigned int)(state->window_index_capacity - 1);
+    }
+    state->window_index[slot].key = key;
+    state->window_index[slot].node = node;
+    state->window_index_count++;
+    return 1;
+}
+void WindowIndexRemove(GooeyShellState *state, Window key)
+{
+    unsigned int mask = 0U;
+    unsigned int slot = 0U;
+    unsigned int next = 0U;
+    if ((state == NULL) || (key == None) || (state->window_index_capacity == 0))
+    {
+        return;
+    }
+    mask = (unsigned int)(state->window_index_capacity - 1);
+    slot = WindowIndexSlot(key, state->window_index_capacity);
+    while (state->window_index[slot].key != key)
+    {
+        if (state->window_index[slot].key == None)
+        {
+            return;
+        }
+        slot = (slot + 1U) & mask;
+    }
+    state->window_index[slot].key = None;
+    state->window_index[slot].node = NULL;
+    state->window_index_count--;
+    next = (slot + 1U) & mask;
+    while (state->window_index[next].key != None)
+    {
+        unsigned int home = WindowIndexSlot(state->window_index[next].key, state->window_index_capacity);
+        if (((next - home) & mask) >= ((next - slot) & mask))
+        {
+            state->window_index[slot] = state->window_index[next];
+            state->window_index[next].key = None;
+            state->window_index[next].node = NULL;
+            slot = next;
+        }
+        next = (next + 1U) & mask;
+    }
+}
+WindowNode *WindowIndexLookup(GooeyShellState *state, Window key)
+{
+    unsigned int slot = 0U;
+    if ((state == NULL) || (key == None) || (state->window_index_capacity == 0))
     {
         return NULL;
     }
-    current = state->window_list;
-    while (current != NULL)
+    slot = WindowIndexSlot(key, state->window_index_capacity);
+    while (state->window_index[slot].key != None)
     {
-        if (current->frame == frame)
+        if (state->window_index[slot].key == key)
         {
-            return current;
+            return state->window_index[slot].node;
         }
-        current = current->next;
+        slot = (slot + 1U) & (unsigned int)(state->window_index_capacity - 1);
+    }
+    return NULL;
+}
+void FreeWindowIndex(GooeyShellState *state)
+{
+    if (state == NULL)
+    {
+        return;
+    }
+    SAFE_FREE(state->window_index);
+    state->window_index_capacity = 0;
+    state->window_index_count = 0;
+}
+WindowNode *FindWindowNodeByFrame(GooeyShellState *state, Window frame)
+{
+    WindowNode *node = NULL;
+    if (ValidateWindowState(state) == 0)
+    {
+        return NULL;
+    }
+    node = WindowIndexLookup(state, frame);
+    if ((node != NULL) && (node->frame == frame))
+    {
+        return node;
     }
     return NULL;
 }
 WindowNode *FindWindowNodeByClient(GooeyShellState *state, Window client)
 {
-    WindowNode *current = NULL;
+    WindowNode *node = NULL;
     if (ValidateWindowState(state) == 0)
     {
         return NULL;
     }
-    current = state->window_list;
-    while (current != NULL)
+    node = WindowIndexLookup(state, client);
+    if ((node != NULL) && (node->client == client))
     {
-        if (current->client == client)
-        {
-            return current;
-        }
-        current = current->next;
+        return node;
     }
     return NULL;
 }
-void DrawTitleBar(GooeyShellState *state, WindowNode *node)
+static void RenderTitleBar(GooeyShellState *state, WindowNode *node, Drawable target, int is_focused)
 {
-    int is_focused = 0;
     unsigned long title_color = 0;
     char display_title[256];
     size_t title_len = 0;
-    if ((ValidateWindowState(state) == 0) || (node == NULL) || (node->is_titlebar_disabled != 0) ||
-        (node->is_desktop_app != 0) || (node->is_fullscreen_app != 0))
-    {
-        return;
-    }
-    is_focused = (state->focused_window == node->frame) ? 1 : 0;
     title_color = (is_focused != 0) ? state->titlebar_focused_color : state->titlebar_color;
     XSetForeground(state->display, state->titlebar_gc, title_color);
-    XFillRectangle(state->display, node->frame, state->titlebar_gc,
-                   BORDER_WIDTH, BORDER_WIDTH,
-                   node->width, TITLE_BAR_HEIGHT);
+    XFillRectangle(state->display, target, state->titlebar_gc,
+                   0, 0, node->width, TITLE_BAR_HEIGHT);
     XSetForeground(state->display, state->text_gc, state->text_color);
     if (node->title != NULL)
     {
@@ -1925,9 +2102,68 @@ void DrawTitleBar(GooeyShellState *state, WindowNode *node)
     {
         strcpy(display_title, "Untitled");
     }
-    XDrawString(state->display, node->frame, state->text_gc,
-                BORDER_WIDTH + 5, BORDER_WIDTH + 15,
-                display_title, strlen(display_title));
+    XDrawString(state->display, target, state->text_gc,
+                5, 15, display_title, strlen(display_title));
+}
+static int TitleBarCacheMatches(WindowNode *node, int is_focused)
+{
+    const char *title = (node->title != NULL) ? node->title : "";
+    return ((node->title_pixmap != None) &&
+            (node->title_pixmap_width == node->width) &&
+            (node->title_pixmap_focused == is_focused) &&
+            (node->title_pixmap_title != NULL) &&
+            (strcmp(node->title_pixmap_title, title) == 0))
+               ? 1
+               : 0;
+}
+void FreeTitleBarCache(GooeyShellState *state, WindowNode *node)
+{
+    if ((state == NULL) || (node == NULL))
+    {
+        return;
+    }
+    if ((node->title_pixmap != None) && (state->display != NULL))
+    {
+        XFreePixmap(state->display, node->title_pixmap);
+    }
+    node->title_pixmap = None;
+    node->title_pixmap_width = 0;
+    SAFE_FREE(node->title_pixmap_title);
+}
+void DrawTitleBar(GooeyShellState *state, WindowNode *node)
+{
+    unsigned long long span_start = 0ULL;
+    int is_focused = 0;
+    if ((ValidateWindowState(state) == 0) || (node == NULL) || (node->is_titlebar_disabled != 0) ||
+        (node->is_desktop_app != 0) || (node->is_fullscreen_app != 0) || (node->width <= 0))
+    {
+        return;
+    }
+    span_start = GetMonotonicTimeNs();
+    is_focused = (state->focused_window == node->frame) ? 1 : 0;
+    if (TitleBarCacheMatches(node, is_focused) == 0)
+    {
+        if ((node->title_pixmap == None) || (node->title_pixmap_width != node->width))
+        {
+            FreeTitleBarCache(state, node);
+            node->title_pixmap = XCreatePixmap(state->display, node->frame,
+                                               (unsigned int)node->width, TITLE_BAR_HEIGHT,
+                                               (unsigned int)DefaultDepth(state->display, state->screen));
+            if (node->title_pixmap == None)
+            {
+                LogError("DrawTitleBar: Failed to create title bar pixmap");
+                return;
+            }
+            node->title_pixmap_width = node->width;
+        }
+        RenderTitleBar(state, node, node->title_pixmap, is_focused);
+        SAFE_FREE(node->title_pixmap_title);
+        node->title_pixmap_title = StrDup((node->title != NULL) ? node->title : "");
+        node->title_pixmap_focused = is_focused;
+    }
+    XCopyArea(state->display, node->title_pixmap, node->frame, state->titlebar_gc,
+              0, 0, (unsigned int)node->width, TITLE_BAR_HEIGHT, BORDER_WIDTH, BORDER_WIDTH);
+    TraceSpan(state, "DrawTitleBar", span_start, node->frame);
 }
 int GetTitleBarButtonArea(GooeyShellState *state, WindowNode *node, int x, int y)
 {
@@ -2037,8 +2273,9 @@ void ToggleFullscreen(GooeyShellState *state, WindowNode *node)
                           node->width + 2 * BORDER_WIDTH,
                           node->height + TITLE_BAR_HEIGHT + 2 * BORDER_WIDTH);
         XResizeWindow(state->display, node->client, node->width, node->height);
+        InvalidateWindowGeometry(node);
         node->is_fullscreen = False;
-        SendWindowStateThroughDBus(state, node->frame, "restored");
+        QueueWindowStateSignal(state, node->frame, "restored");
     }
     else
     {
@@ -2059,9 +2296,10 @@ void ToggleFullscreen(GooeyShellState *state, WindowNode *node)
             XResizeWindow(state->display, node->client,
                           mon->width - 2 * BORDER_WIDTH,
                           mon->height - bar_height - TITLE_BAR_HEIGHT - 2 * BORDER_WIDTH);
+            InvalidateWindowGeometry(node);
         }
         node->is_fullscreen = True;
-        SendWindowStateThroughDBus(state, node->frame, "fullscreen");
+        QueueWindowStateSignal(state, node->frame, "fullscreen");
     }
     if (node->is_titlebar_disabled == 0)
     {
@@ -2134,7 +2372,7 @@ void HandleButtonPress(GooeyShellState *state, XButtonEvent *ev)
         return;
     }
     FocusWindow(state, node);
-    XRaiseWindow(state->display, ev->window);
+    RaiseWindowNode(state, node);
     if (ev->button == Button1)
     {
         relative_x = ev->x;
@@ -2223,49 +2461,24 @@ void HandleButtonPress(GooeyShellState *state, XButtonEvent *ev)
     {
         GooeyShell_ToggleFloating(state, node->client);
     }
-    EnsureDesktopAppStaysInBackground(state);
-    EnsureFullscreenAppStaysOnTop(state);
 }
-void HandleButtonRelease(GooeyShellState *state, XButtonEvent *ev)
+static void ApplyMotion(GooeyShellState *state, XMotionEvent *ev)
 {
-    if ((state == NULL) || (ev == NULL))
+    WindowNode *node = NULL;
+    int delta_x = 0;
+    int delta_y = 0;
+    int new_x = 0;
+    int new_y = 0;
+    int frame_width = 0;
+    int frame_height = 0;
+    int bar_height = 0;
+    Monitor *mon = NULL;
+    if (state == NULL)
     {
         return;
     }
-    if (((state->is_dragging != 0) || (state->is_resizing != 0) || (state->is_tiling_resizing != 0)) &&
-        (ev->button == Button1))
-    {
-        state->is_dragging = False;
-        state->is_resizing = False;
-        state->is_tiling_resizing = False;
-        WindowNode *node = FindWindowNodeByFrame(state, state->drag_window);
-        if (node != NULL)
-        {
-            XDefineCursor(state->display, node->frame, state->custom_cursor);
-        }
-        state->drag_window = None;
-        XUngrabPointer(state->display, CurrentTime);
-    }
-    EnsureDesktopAppStaysInBackground(state);
-    EnsureFullscreenAppStaysOnTop(state);
-}
-void HandleMotionNotify(GooeyShellState *state, XMotionEvent *ev)
-{
-    WindowNode *node = NULL;
-    int delta_x = 0;
-    int delta_y = 0;
-    int new_x = 0;
-    int new_y = 0;
-    int frame_width = 0;
-    int frame_height = 0;
-    int bar_height = 0;
-    Monitor *mon = NULL;
-    if (state == NULL)
-    {
-        return;
-    }
-    node = FindWindowNodeByFrame(state, ev->window);
-    if ((node == NULL) || (node->is_desktop_app != 0) || (node->is_fullscreen_app != 0))
+    node = FindWindowNodeByFrame(state, ev->window);
+    if ((node == NULL) || (node->is_desktop_app != 0) || (node->is_fullscreen_app != 0))
     {
         return;
     }
@@ -2365,10 +2578,128 @@ void HandleMotionNotify(GooeyShellState *state, XMotionEvent *ev)
         UpdateCursorForWindow(state, node, ev->x, ev->y);
     }
 }
-void ReapZombieProcesses(void)
+static unsigned long long GetMotionCommitIntervalNs(GooeyShellState *state)
+{
+    WindowNode *node = NULL;
+    int rate = state->motion_commit_rate;
+    if (rate <= 0)
+    {
+        node = FindWindowNodeByFrame(state, state->drag_window);
+        if ((node != NULL) && (node->monitor_number >= 0) &&
+            (node->monitor_number < state->monitor_info.num_monitors))
+        {
+            rate = state->monitor_info.monitors[node->monitor_number].refresh_rate;
+        }
+    }
+    if (rate <= 0)
+    {
+        rate = DEFAULT_MOTION_COMMIT_RATE;
+    }
+    return 1000000000ULL / (unsigned long long)rate;
+}
+static void CommitPendingMotion(GooeyShellState *state)
+{
+    if (state->has_pending_motion == 0)
+    {
+        return;
+    }
+    state->has_pending_motion = 0;
+    state->last_motion_commit_ns = GetMonotonicTimeNs();
+    state->motion_events_committed++;
+    ApplyMotion(state, &state->pending_motion);
+}
+static void MotionCommitTimer(GooeyShellState *state, void *data)
+{
+    (void)data;
+    state->motion_commit_timer = -1;
+    CommitPendingMotion(state);
+}
+static void ScheduleMotionCommit(GooeyShellState *state)
+{
+    unsigned long long interval = 0ULL;
+    unsigned long long elapsed = 0ULL;
+    int delay_ms = 0;
+    if (state->motion_commit_timer >= 0)
+    {
+        return;
+    }
+    interval = GetMotionCommitIntervalNs(state);
+    elapsed = GetMonotonicTimeNs() - state->last_motion_commit_ns;
+    if (elapsed >= interval)
+    {
+        CommitPendingMotion(state);
+        return;
+    }
+    delay_ms = (int)(((interval - elapsed) + 999999ULL) / 1000000ULL);
+    state->motion_commit_timer = AddTimer(state, delay_ms, MotionCommitTimer, NULL);
+    if (state->motion_commit_timer < 0)
+    {
+        CommitPendingMotion(state);
+    }
+}
+static void FlushPendingMotion(GooeyShellState *state)
+{
+    if (state->motion_commit_timer >= 0)
+    {
+        CancelTimer(state, state->motion_commit_timer);
+        state->motion_commit_timer = -1;
+    }
+    CommitPendingMotion(state);
+}
+void HandleMotionNotify(GooeyShellState *state, XMotionEvent *ev)
+{
+    XEvent next;
+    if ((state == NULL) || (ev == NULL))
+    {
+        return;
+    }
+    if (((state->is_dragging != 0) || (state->is_resizing != 0) || (state->is_tiling_resizing != 0)) &&
+        (ev->window == state->drag_window))
+    {
+        if (state->has_pending_motion != 0)
+        {
+            state->motion_events_dropped++;
+        }
+        state->pending_motion = *ev;
+        while (XEventsQueued(state->display, QueuedAfterReading) != 0)
+        {
+            XPeekEvent(state->display, &next);
+            if ((next.type != MotionNotify) || (next.xmotion.window != ev->window))
+            {
+                break;
+            }
+            XNextEvent(state->display, &next);
+            state->pending_motion = next.xmotion;
+            state->motion_events_dropped++;
+        }
+        state->has_pending_motion = 1;
+        ScheduleMotionCommit(state);
+        return;
+    }
+    ApplyMotion(state, ev);
+}
+void HandleButtonRelease(GooeyShellState *state, XButtonEvent *ev)
 {
-    while (waitpid(-1, NULL, WNOHANG) > 0)
+    if ((state == NULL) || (ev == NULL))
+    {
+        return;
+    }
+    if (((state->is_dragging != 0) || (state->is_resizing != 0) || (state->is_tiling_resizing != 0)) &&
+        (ev->button == Button1))
     {
+        FlushPendingMotion(state);
+        LogDebug("HandleButtonRelease: Motion events committed %lu, dropped %lu",
+                state->motion_events_committed, state->motion_events_dropped);
+        state->is_dragging = False;
+        state->is_resizing = False;
+        state->is_tiling_resizing = False;
+        WindowNode *node = FindWindowNodeByFrame(state, state->drag_window);
+        if (node != NULL)
+        {
+            XDefineCursor(state->display, node->frame, state->custom_cursor);
+        }
+        state->drag_window = None;
+        XUngrabPointer(state->display, CurrentTime);
     }
 }
 void MinimizeWindow(GooeyShellState *state, WindowNode *node)
@@ -2384,7 +2715,7 @@ void MinimizeWindow(GooeyShellState *state, WindowNode *node)
     LogInfo("MinimizeWindow: Minimizing window: %s", (node->title != NULL) ? node->title : "unknown");
     XWithdrawWindow(state->display, node->frame, state->screen);
     node->is_minimized = True;
-    SendWindowStateThroughDBus(state, node->frame, "minimized");
+    QueueWindowStateSignal(state, node->frame, "minimized");
     if (state->focused_window == node->frame)
     {
         FocusRootWindow(state);
@@ -2402,7 +2733,7 @@ void RestoreWindow(GooeyShellState *state, WindowNode *node)
         return;
     }
     LogInfo("RestoreWindow: Restoring window: %s", (node->title != NULL) ? node->title : "unknown");
-    XMapRaised(state->display, node->frame);
+    XMapWindow(state->display, node->frame);
     XMapWindow(state->display, node->client);
     node->is_minimized = False;
     if (node->is_titlebar_disabled == 0)
@@ -2410,389 +2741,408 @@ void RestoreWindow(GooeyShellState *state, WindowNode *node)
         DrawTitleBar(state, node);
     }
     FocusWindow(state, node);
-    SendWindowStateThroughDBus(state, node->frame, "restored");
+    QueueWindowStateSignal(state, node->frame, "restored");
     OptimizedXFlush(state);
 }
-void GooeyShell_RunEventLoop(GooeyShellState *state)
+static void HandleKeyPress(GooeyShellState *state, XKeyEvent *ev)
 {
-    XEvent ev;
-    int reap_counter = 0;
-    if (ValidateWindowState(state) == 0)
+    int arg = 0;
+    switch (LookupKeybind(state, ev, &arg))
     {
-        return;
-    }
-    while (1)
-    {
-        reap_counter++;
-        if (reap_counter >= 100)
+    case KEY_ACTION_LAUNCH_TERMINAL:
+        LogDebug("GooeyShell_RunEventLoop: Launching terminal");
+        GooeyShell_AddWindow(state, "xterm", 0);
+        break;
+    case KEY_ACTION_CLOSE_WINDOW:
+        LogDebug("GooeyShell_RunEventLoop: Closing window");
+        if (state->focused_window != None)
         {
-            ReapZombieProcesses();
-            reap_counter = 0;
+            WindowNode *node = FindWindowNodeByFrame(state, state->focused_window);
+            if ((node != NULL) && (node->is_desktop_app == 0) && (node->is_fullscreen_app == 0))
+            {
+                CloseWindow(state, node);
+            }
         }
-        while (XPending(state->display) != 0)
+        break;
+    case KEY_ACTION_TOGGLE_FLOATING:
+        LogDebug("GooeyShell_RunEventLoop: Toggling floating");
+        if (state->focused_window != None)
         {
-            XNextEvent(state->display, &ev);
-            switch (ev.type)
+            WindowNode *node = FindWindowNodeByFrame(state, state->focused_window);
+            if ((node != NULL) && (node->is_desktop_app == 0) && (node->is_fullscreen_app == 0))
             {
-            case MapRequest:
-            {
-                Window client = ev.xmaprequest.window;
-                if (FindWindowNodeByClient(state, client) != NULL)
-                {
-                    break;
-                }
-                XWindowAttributes attr;
-                if (XGetWindowAttributes(state->display, client, &attr) == 0)
-                {
-                    break;
-                }
-                if (attr.override_redirect != 0)
-                {
-                    XMapWindow(state->display, client);
-                    break;
-                }
-                int is_desktop_app = 0;
-                int is_fullscreen_app = 0;
-                int stay_on_top = 0;
-                is_desktop_app = IsDesktopAppByProperties(state, client);
-                if (is_desktop_app == 0)
-                {
-                    is_fullscreen_app = IsFullscreenAppByProperties(state, client, &stay_on_top);
-                }
-                if ((is_desktop_app == 0) && (is_fullscreen_app == 0))
-                {
-                    (void)DetectAppTypeByTitleClass(state, client, &is_desktop_app, &is_fullscreen_app, &stay_on_top);
-                }
-                if (is_desktop_app != 0)
-                {
-                    (void)CreateFrameWindow(state, client, 1);
-                }
-                else if (is_fullscreen_app != 0)
-                {
-                    (void)CreateFullscreenAppWindow(state, client, stay_on_top);
-                }
-                else
-                {
-                    (void)CreateFrameWindow(state, client, 0);
-                }
-                break;
+                GooeyShell_ToggleFloating(state, node->client);
             }
-            case UnmapNotify:
-                break;
-            case DestroyNotify:
-                if (ev.xdestroywindow.window != state->root)
-                {
-                    RemoveWindow(state, ev.xdestroywindow.window);
-                }
-                break;
-            case ClientMessage:
+        }
+        break;
+    case KEY_ACTION_FOCUS_NEXT_WINDOW:
+        LogDebug("GooeyShell_RunEventLoop: Focusing next window");
+        GooeyShell_FocusNextWindow(state);
+        break;
+    case KEY_ACTION_FOCUS_PREVIOUS_WINDOW:
+        LogDebug("GooeyShell_RunEventLoop: Focusing previous window");
+        GooeyShell_FocusPreviousWindow(state);
+        break;
+    case KEY_ACTION_SET_TILING_LAYOUT:
+        LogDebug("GooeyShell_RunEventLoop: Switching to tiling layout");
+        GooeyShell_SetLayout(state, LAYOUT_TILING);
+        break;
+    case KEY_ACTION_SET_MONOCLE_LAYOUT:
+        LogDebug("GooeyShell_RunEventLoop: Switching to monocle layout");
+        GooeyShell_SetLayout(state, LAYOUT_MONOCLE);
+        break;
+    case KEY_ACTION_SET_MASTER_STACK_LAYOUT:
+        LogDebug("GooeyShell_RunEventLoop: Switching to master-stack layout");
+        GooeyShell_SetLayout(state, LAYOUT_MASTER_STACK);
+        break;
+    case KEY_ACTION_SET_GRID_LAYOUT:
+        LogDebug("GooeyShell_RunEventLoop: Switching to grid layout");
+        GooeyShell_SetLayout(state, LAYOUT_GRID);
+        break;
+    case KEY_ACTION_SET_COLUMNS_LAYOUT:
+        LogDebug("GooeyShell_RunEventLoop: Switching to columns layout");
+        GooeyShell_SetLayout(state, LAYOUT_COLUMNS);
+        break;
+    case KEY_ACTION_SHRINK_WIDTH:
+    {
+        LogDebug("GooeyShell_RunEventLoop: Making window narrower");
+        Workspace *ws = GetCurrentWorkspace(state);
+        if ((ws != NULL) && (ws->monitor_tiling_roots != NULL) && (state->focused_window != None))
+        {
+            WindowNode *node = FindWindowNodeByFrame(state, state->focused_window);
+            if ((node != NULL) && (node->is_floating == 0))
             {
-                if ((ev.xclient.message_type == atoms.wm_protocols) &&
-                    ((Atom)ev.xclient.data.l[0] == atoms.wm_delete_window))
-                {
-                    WindowNode *node = FindWindowNodeByClient(state, ev.xclient.window);
-                    if (node != NULL)
-                    {
-                        CloseWindow(state, node);
-                    }
-                }
-                break;
+                HandleTilingResize(state, node, 1, -30, 0);
             }
-            case ConfigureRequest:
+        }
+        break;
+    }
+    case KEY_ACTION_GROW_WIDTH:
+    {
+        LogDebug("GooeyShell_RunEventLoop: Making window wider");
+        Workspace *ws = GetCurrentWorkspace(state);
+        if ((ws != NULL) && (ws->monitor_tiling_roots != NULL) && (state->focused_window != None))
+        {
+            WindowNode *node = FindWindowNodeByFrame(state, state->focused_window);
+            if ((node != NULL) && (node->is_floating == 0))
             {
-                WindowNode *node = FindWindowNodeByClient(state, ev.xconfigurerequest.window);
-                if ((node != NULL) && (node->is_fullscreen == 0) &&
-                    (node->is_desktop_app == 0) && (node->is_fullscreen_app == 0))
-                {
-                    node->width = (ev.xconfigurerequest.width > 0) ? ev.xconfigurerequest.width : node->width;
-                    node->height = (ev.xconfigurerequest.height > 0) ? ev.xconfigurerequest.height : node->height;
-                    UpdateWindowGeometry(state, node);
-                    if (node->is_titlebar_disabled == 0)
-                    {
-                        DrawTitleBar(state, node);
-                    }
-                }
-                else if (node == NULL)
-                {
-                    XWindowChanges changes;
-                    XErrorHandler old = NULL;
-                    changes.x = ev.xconfigurerequest.x;
-                    changes.y = ev.xconfigurerequest.y;
-                    changes.width = ev.xconfigurerequest.width;
-                    changes.height = ev.xconfigurerequest.height;
-                    changes.border_width = ev.xconfigurerequest.border_width;
-                    changes.sibling = ev.xconfigurerequest.above;
-                    changes.stack_mode = ev.xconfigurerequest.detail;
-                    old = XSetErrorHandler(IgnoreXError);
-                    XConfigureWindow(state->display, ev.xconfigurerequest.window,
-                                     ev.xconfigurerequest.value_mask, &changes);
-                    XSync(state->display, False);
-                    XSetErrorHandler(old);
-                }
-                break;
+                HandleTilingResize(state, node, 1, 30, 0);
             }
-            case Expose:
+        }
+        break;
+    }
+    case KEY_ACTION_SHRINK_HEIGHT:
+    {
+        LogDebug("GooeyShell_RunEventLoop: Making window shorter");
+        Workspace *ws = GetCurrentWorkspace(state);
+        if ((ws != NULL) && (ws->monitor_tiling_roots != NULL) && (state->focused_window != None))
+        {
+            WindowNode *node = FindWindowNodeByFrame(state, state->focused_window);
+            if ((node != NULL) && (node->is_floating == 0))
             {
-                WindowNode *node = FindWindowNodeByFrame(state, ev.xexpose.window);
-                if ((node != NULL) && (ev.xexpose.count == 0) && (node->is_titlebar_disabled == 0))
-                {
-                    DrawTitleBar(state, node);
-                }
-                break;
+                HandleTilingResize(state, node, 2, 0, -30);
             }
-            case EnterNotify:
+        }
+        break;
+    }
+    case KEY_ACTION_GROW_HEIGHT:
+    {
+        LogDebug("GooeyShell_RunEventLoop: Making window taller");
+        Workspace *ws = GetCurrentWorkspace(state);
+        if ((ws != NULL) && (ws->monitor_tiling_roots != NULL) && (state->focused_window != None))
+        {
+            WindowNode *node = FindWindowNodeByFrame(state, state->focused_window);
+            if ((node != NULL) && (node->is_floating == 0))
             {
-                WindowNode *node = FindWindowNodeByFrame(state, ev.xcrossing.window);
-                if ((node != NULL) && (node->is_titlebar_disabled == 0))
-                {
-                    XDefineCursor(state->display, node->frame, state->custom_cursor);
-                }
-                break;
+                HandleTilingResize(state, node, 2, 0, 30);
             }
-            case ButtonPress:
-                HandleButtonPress(state, &ev.xbutton);
-                break;
-            case ButtonRelease:
-                HandleButtonRelease(state, &ev.xbutton);
-                break;
-            case MotionNotify:
-                HandleMotionNotify(state, &ev.xmotion);
-                break;
-            case KeyPress:
+        }
+        break;
+    }
+    case KEY_ACTION_TOGGLE_LAYOUT:
+    {
+        LogDebug("GooeyShell_RunEventLoop: Toggling layout");
+        Workspace *ws = GetCurrentWorkspace(state);
+        if (ws != NULL)
+        {
+            if (ws->layout == LAYOUT_TILING)
             {
-                if (KeybindMatches(state, &ev.xkey, state->keybinds.launch_terminal) != 0)
-                {
-                    LogInfo("GooeyShell_RunEventLoop: Launching terminal");
-                    GooeyShell_AddWindow(state, "xterm", 0);
-                }
-                else if (KeybindMatches(state, &ev.xkey, state->keybinds.close_window) != 0)
-                {
-                    LogInfo("GooeyShell_RunEventLoop: Closing window");
-                    if (state->focused_window != None)
-                    {
-                        WindowNode *node = FindWindowNodeByFrame(state, state->focused_window);
-                        if ((node != NULL) && (node->is_desktop_app == 0) && (node->is_fullscreen_app == 0))
-                        {
-                            CloseWindow(state, node);
-                        }
-                    }
-                }
-                else if (KeybindMatches(state, &ev.xkey, state->keybinds.toggle_floating) != 0)
-                {
-                    LogInfo("GooeyShell_RunEventLoop: Toggling floating");
-                    if (state->focused_window != None)
-                    {
-                        WindowNode *node = FindWindowNodeByFrame(state, state->focused_window);
-                        if ((node != NULL) && (node->is_desktop_app == 0) && (node->is_fullscreen_app == 0))
-                        {
-                            GooeyShell_ToggleFloating(state, node->client);
-                        }
-                    }
-                }
-                else if (KeybindMatches(state, &ev.xkey, state->keybinds.focus_next_window) != 0)
-                {
-                    LogInfo("GooeyShell_RunEventLoop: Focusing next window");
-                    GooeyShell_FocusNextWindow(state);
-                }
-                else if (KeybindMatches(state, &ev.xkey, state->keybinds.focus_previous_window) != 0)
-                {
-                    LogInfo("GooeyShell_RunEventLoop: Focusing previous window");
-                    GooeyShell_FocusPreviousWindow(state);
-                }
-                else if (KeybindMatches(state, &ev.xkey, state->keybinds.set_tiling_layout) != 0)
-                {
-                    LogInfo("GooeyShell_RunEventLoop: Switching to tiling layout");
-                    GooeyShell_SetLayout(state, LAYOUT_TILING);
-                }
-                else if (KeybindMatches(state, &ev.xkey, state->keybinds.set_monocle_layout) != 0)
-                {
-                    LogInfo("GooeyShell_RunEventLoop: Switching to monocle layout");
-                    GooeyShell_SetLayout(state, LAYOUT_MONOCLE);
-                }
-                else if (KeybindMatches(state, &ev.xkey, state->keybinds.shrink_width) != 0)
-                {
-                    LogInfo("GooeyShell_RunEventLoop: Making window narrower");
-                    Workspace *ws = GetCurrentWorkspace(state);
-                    if ((ws != NULL) && (ws->monitor_tiling_roots != NULL) && (state->focused_window != None))
-                    {
-                        WindowNode *node = FindWindowNodeByFrame(state, state->focused_window);
-                        if ((node != NULL) && (node->is_floating == 0))
-                        {
-                            HandleTilingResize(state, node, 1, -30, 0);
-                        }
-                    }
-                }
-                else if (KeybindMatches(state, &ev.xkey, state->keybinds.grow_width) != 0)
-                {
-                    LogInfo("GooeyShell_RunEventLoop: Making window wider");
-                    Workspace *ws = GetCurrentWorkspace(state);
-                    if ((ws != NULL) && (ws->monitor_tiling_roots != NULL) && (state->focused_window != None))
-                    {
-                        WindowNode *node = FindWindowNodeByFrame(state, state->focused_window);
-                        if ((node != NULL) && (node->is_floating == 0))
-                        {
-                            HandleTilingResize(state, node, 1, 30, 0);
-                        }
-                    }
-                }
-                else if (KeybindMatches(state, &ev.xkey, state->keybinds.shrink_height) != 0)
-                {
-                    LogInfo("GooeyShell_RunEventLoop: Making window shorter");
-                    Workspace *ws = GetCurrentWorkspace(state);
-                    if ((ws != NULL) && (ws->monitor_tiling_roots != NULL) && (state->focused_window != None))
-                    {
-                        WindowNode *node = FindWindowNodeByFrame(state, state->focused_window);
-                        if ((node != NULL) && (node->is_floating == 0))
-                        {
-                            HandleTilingResize(state, node, 2, 0, -30);
-                        }
-                    }
-                }
-                else if (KeybindMatches(state, &ev.xkey, state->keybinds.grow_height) != 0)
-                {
-                    LogInfo("GooeyShell_RunEventLoop: Making window taller");
-                    Workspace *ws = GetCurrentWorkspace(state);
-                    if ((ws != NULL) && (ws->monitor_tiling_roots != NULL) && (state->focused_window != None))
-                    {
-                        WindowNode *node = FindWindowNodeByFrame(state, state->focused_window);
-                        if ((node != NULL) && (node->is_floating == 0))
-                        {
-                            HandleTilingResize(state, node, 2, 0, 30);
-                        }
-                    }
-                }
-                else if (KeybindMatches(state, &ev.xkey, state->keybinds.toggle_layout) != 0)
-                {
-                    LogInfo("GooeyShell_RunEventLoop: Toggling layout");
-                    Workspace *ws = GetCurrentWorkspace(state);
-                    if (ws != NULL)
-                    {
-                        if (ws->layout == LAYOUT_TILING)
-                        {
-                            GooeyShell_SetLayout(state, LAYOUT_MONOCLE);
-                        }
-                        else
-                        {
-                            GooeyShell_SetLayout(state, LAYOUT_TILING);
-                        }
-                    }
-                }
-                else if (KeybindMatches(state, &ev.xkey, state->keybinds.move_window_prev_monitor) != 0)
-                {
-                    LogInfo("GooeyShell_RunEventLoop: Moving window to previous monitor");
-                    GooeyShell_MoveWindowToPreviousMonitor(state);
-                }
-                else if (KeybindMatches(state, &ev.xkey, state->keybinds.move_window_next_monitor) != 0)
-                {
-                    LogInfo("GooeyShell_RunEventLoop: Moving window to next monitor");
-                    GooeyShell_MoveWindowToNextMonitor(state);
-                }
-                else if (KeybindMatches(state, &ev.xkey, state->keybinds.launch_menu) != 0)
-                {
-                    LogInfo("GooeyShell_RunEventLoop: Launching app menu");
-                    LaunchAppMenu(state);
-                }
-                else if (KeybindMatches(state, &ev.xkey, state->keybinds.logout) != 0)
-                {
-                    LogInfo("GooeyShell_RunEventLoop: Logging out");
-                    GooeyShell_Logout(state);
-                }
-                else
-                {
-                    for (int i = 0; i < 9; i++)
-                    {
-                        if (KeybindMatches(state, &ev.xkey, state->keybinds.switch_workspace[i]) != 0)
-                        {
-                            LogInfo("GooeyShell_RunEventLoop: Switching to workspace %d", i + 1);
-                            GooeyShell_SwitchWorkspace(state, i + 1);
-                            break;
-                        }
-                    }
-                }
-                break;
+                GooeyShell_SetLayout(state, LAYOUT_MONOCLE);
             }
-            default:
-                break;
+            else
+            {
+                GooeyShell_SetLayout(state, LAYOUT_TILING);
             }
         }
-        if (XPending(state->display) == 0)
+        break;
+    }
+    case KEY_ACTION_MOVE_WINDOW_PREV_MONITOR:
+        LogDebug("GooeyShell_RunEventLoop: Moving window to previous monitor");
+        GooeyShell_MoveWindowToPreviousMonitor(state);
+        break;
+    case KEY_ACTION_MOVE_WINDOW_NEXT_MONITOR:
+        LogDebug("GooeyShell_RunEventLoop: Moving window to next monitor");
+        GooeyShell_MoveWindowToNextMonitor(state);
+        break;
+    case KEY_ACTION_LAUNCH_MENU:
+        LogDebug("GooeyShell_RunEventLoop: Launching app menu");
+        LaunchAppMenu(state);
+        break;
+    case KEY_ACTION_LOGOUT:
+        LogDebug("GooeyShell_RunEventLoop: Logging out");
+        GooeyShell_Logout(state);
+        break;
+    case KEY_ACTION_SWITCH_WORKSPACE:
+        LogDebug("GooeyShell_RunEventLoop: Switching to workspace %d", arg);
+        GooeyShell_SwitchWorkspace(state, arg);
+        break;
+    default:
+        break;
+    }
+}
+void HandleXEvent(GooeyShellState *state, XEvent *ev)
+{
+    switch (ev->type)
+    {
+    case MapRequest:
+    {
+        Window client = ev->xmaprequest.window;
+        WindowProbe probe;
+        if (FindWindowNodeByClient(state, client) != NULL)
+        {
+            break;
+        }
+        if (ProbeWindow(state, client, &probe) == 0)
+        {
+            FreeWindowProbe(&probe);
+            break;
+        }
+        if (probe.override_redirect != 0)
         {
-            usleep(5000);
+            FreeWindowProbe(&probe);
+            XMapWindow(state->display, client);
+            break;
+        }
+        int is_desktop_app = 0;
+        int is_fullscreen_app = 0;
+        int stay_on_top = 0;
+        ClassifyWindowProbe(&probe, &is_desktop_app, &is_fullscreen_app, &stay_on_top);
+        if (is_desktop_app != 0)
+        {
+            (void)CreateFrameWindow(state, client, 1, &probe);
+        }
+        else if (is_fullscreen_app != 0)
+        {
+            (void)CreateFullscreenAppWindow(state, client, stay_on_top, &probe);
         }
-        EnsureDesktopAppStaysInBackground(state);
-        EnsureFullscreenAppStaysOnTop(state);
-        if (pending_x_flush != 0)
+        else
         {
-            XFlush(state->display);
-            pending_x_flush = 0;
+            (void)CreateFrameWindow(state, client, 0, &probe);
         }
+        FreeWindowProbe(&probe);
+        break;
     }
-}
-void GooeyShell_AddFullscreenApp(GooeyShellState *state, const char *command, int stay_on_top)
-{
-    pid_t pid = 0;
-    int max_fd = 0;
-    if ((state == NULL) || (command == NULL))
+    case UnmapNotify:
+        break;
+    case DestroyNotify:
+        if (ev->xdestroywindow.window != state->root)
+        {
+            RemoveWindow(state, ev->xdestroywindow.window);
+        }
+        break;
+    case ClientMessage:
     {
-        return;
+        if ((ev->xclient.message_type == atoms.wm_protocols) &&
+            ((Atom)ev->xclient.data.l[0] == atoms.wm_delete_window))
+        {
+            WindowNode *node = FindWindowNodeByClient(state, ev->xclient.window);
+            if (node != NULL)
+            {
+                CloseWindow(state, node);
+            }
+        }
+        break;
+    }
+    case ConfigureRequest:
+    {
+        WindowNode *node = FindWindowNodeByClient(state, ev->xconfigurerequest.window);
+        if ((node != NULL) && (node->is_fullscreen == 0) &&
+            (node->is_desktop_app == 0) && (node->is_fullscreen_app == 0))
+        {
+            int old_width = node->width;
+            int old_height = node->height;
+            node->width = (ev->xconfigurerequest.width > 0) ? ev->xconfigurerequest.width : node->width;
+            node->height = (ev->xconfigurerequest.height > 0) ? ev->xconfigurerequest.height : node->height;
+            UpdateWindowGeometry(state, node);
+            if ((node->width == old_width) && (node->height == old_height))
+            {
+                SendSyntheticConfigureNotify(state, node);
+            }
+            if (node->is_titlebar_disabled == 0)
+            {
+                DrawTitleBar(state, node);
+            }
+        }
+        else if (node == NULL)
+        {
+            XWindowChanges changes;
+            XErrorHandler old = NULL;
+            changes.x = ev->xconfigurerequest.x;
+            changes.y = ev->xconfigurerequest.y;
+            changes.width = ev->xconfigurerequest.width;
+            changes.height = ev->xconfigurerequest.height;
+            changes.border_width = ev->xconfigurerequest.border_width;
+            changes.sibling = ev->xconfigurerequest.above;
+            changes.stack_mode = ev->xconfigurerequest.detail;
+            old = XSetErrorHandler(IgnoreXError);
+            XConfigureWindow(state->display, ev->xconfigurerequest.window,
+                             ev->xconfigurerequest.value_mask, &changes);
+            XSync(state->display, False);
+            XSetErrorHandler(old);
+        }
+        break;
     }
-    pid = fork();
-    if (pid == 0)
+    case Expose:
     {
-        setenv("GOOEY_FULLSCREEN_APP", "1", 1);
-        if (stay_on_top != 0)
+        WindowNode *node = FindWindowNodeByFrame(state, ev->xexpose.window);
+        if ((node != NULL) && (ev->xexpose.count == 0) && (node->is_titlebar_disabled == 0))
         {
-            setenv("GOOEY_STAY_ON_TOP", "1", 1);
+            DrawTitleBar(state, node);
         }
-        max_fd = sysconf(_SC_OPEN_MAX);
-        if (max_fd == -1)
+        break;
+    }
+    case EnterNotify:
+    {
+        WindowNode *node = FindWindowNodeByFrame(state, ev->xcrossing.window);
+        if ((node != NULL) && (node->is_titlebar_disabled == 0))
         {
-            max_fd = 1024;
+            XDefineCursor(state->display, node->frame, state->custom_cursor);
         }
-        for (int i = 3; i < max_fd; i++)
+        break;
+    }
+    case ButtonPress:
+        HandleButtonPress(state, &ev->xbutton);
+        break;
+    case ButtonRelease:
+        HandleButtonRelease(state, &ev->xbutton);
+        break;
+    case MotionNotify:
+        HandleMotionNotify(state, &ev->xmotion);
+        break;
+    case KeyPress:
+        HandleKeyPress(state, &ev->xkey);
+        break;
+    case MappingNotify:
+        if ((ev->xmapping.request == MappingKeyboard) || (ev->xmapping.request == MappingModifier))
         {
-            (void)close(i);
+            XRefreshKeyboardMapping(&ev->xmapping);
+            GrabKeys(state);
         }
-        execlp("sh", "sh", "-c", command, NULL);
-        LogError("GooeyShell_AddFullscreenApp: Failed to execute fullscreen app: %s", command);
-        _exit(1);
+        break;
+    default:
+        (void)HandleRandrEvent(state, ev);
+        break;
     }
-    else if (pid < 0)
+}
+int ProcessPendingXEvents(GooeyShellState *state)
+{
+    XEvent ev;
+    int handled = 0;
+    while (XPending(state->display) != 0)
     {
-        LogError("GooeyShell_AddFullscreenApp: Failed to fork for fullscreen app: %s", command);
+        unsigned long long start_ns = 0ULL;
+        unsigned long start_request = 0;
+        XNextEvent(state->display, &ev);
+        start_ns = GetMonotonicTimeNs();
+        start_request = NextRequest(state->display);
+        HandleXEvent(state, &ev);
+        RecordEventStats(state, ev.type, GetMonotonicTimeNs() - start_ns, NextRequest(state->display) - start_request);
+        TraceSpan(state, GetXEventName(ev.type), start_ns, ev.xany.window);
+        handled++;
     }
+    return handled;
 }
-void GooeyShell_AddWindow(GooeyShellState *state, const char *command, int desktop_app)
+void GooeyShell_RunEventLoop(GooeyShellState *state)
 {
-    pid_t pid = 0;
-    int max_fd = 0;
-    if ((state == NULL) || (command == NULL))
+    if (ValidateWindowState(state) == 0)
     {
         return;
     }
-    pid = fork();
-    if (pid == 0)
+    state->is_running = 1;
+    while (state->is_running != 0)
     {
-        if (desktop_app != 0)
+        unsigned long long span_start = 0ULL;
+        unsigned long flush_request = 0;
+        int signals_pending = 0;
+        (void)ProcessPendingXEvents(state);
+        if (state->monitor_refresh_pending != 0)
+        {
+            ApplyMonitorChanges(state);
+        }
+        span_start = GetMonotonicTimeNs();
+        if (CommitStacking(state) != 0)
+        {
+            TraceSpan(state, "CommitStacking", span_start, None);
+        }
+        span_start = GetMonotonicTimeNs();
+        if (CommitWindowGeometry(state) != 0)
         {
-            setenv("GOOEY_DESKTOP_APP", "1", 1);
+            TraceSpan(state, "CommitWindowGeometry", span_start, None);
         }
-        max_fd = sysconf(_SC_OPEN_MAX);
-        if (max_fd == -1)
+        PublishWindowSnapshot(state);
+        signals_pending = ((state->focus_signal_pending != 0) || (state->workspace_signal_pending != 0) ||
+                           (state->pending_window_state_count != 0)) ? 1 : 0;
+        span_start = GetMonotonicTimeNs();
+        FlushPendingSignals(state);
+        if (signals_pending != 0)
         {
-            max_fd = 1024;
+            TraceSpan(state, "FlushPendingSignals", span_start, None);
         }
-        for (int i = 3; i < max_fd; i++)
+        span_start = GetMonotonicTimeNs();
+        flush_request = NextRequest(state->display);
+        XFlush(state->display);
+        if (flush_request != state->last_flush_request)
         {
-            (void)close(i);
+            TraceSpan(state, "XFlush", span_start, None);
+            state->last_flush_request = flush_request;
+        }
+        pending_x_flush = 0;
+        if (XEventsQueued(state->display, QueuedAlready) != 0)
+        {
+            continue;
+        }
+        if (WaitForLoopEvents(state) < 0)
+        {
+            break;
         }
-        execlp("sh", "sh", "-c", command, NULL);
-        LogError("GooeyShell_AddWindow: Failed to execute command: %s", command);
-        _exit(1);
     }
-    else if (pid < 0)
+}
+void GooeyShell_AddFullscreenApp(GooeyShellState *state, const char *command, int stay_on_top)
+{
+    const char *env[] = {"GOOEY_FULLSCREEN_APP=1", NULL, NULL};
+    if ((state == NULL) || (command == NULL))
     {
-        LogError("GooeyShell_AddWindow: Failed to fork for command: %s", command);
+        return;
+    }
+    if (stay_on_top != 0)
+    {
+        env[1] = "GOOEY_STAY_ON_TOP=1";
+    }
+    if (SpawnProcess(state, command, env, NULL, NULL) < 0)
+    {
+        LogError("GooeyShell_AddFullscreenApp: Failed to spawn fullscreen app: %s", command);
+    }
+}
+void GooeyShell_AddWindow(GooeyShellState *state, const char *command, int desktop_app)
+{
+    const char *env[] = {"GOOEY_DESKTOP_APP=1", NULL};
+    if ((state == NULL) || (command == NULL))
+    {
+        return;
+    }
+    if (SpawnProcess(state, command, (desktop_app != 0) ? env : NULL, NULL, NULL) < 0)
+    {
+        LogError("GooeyShell_AddWindow: Failed to spawn command: %s", command);
     }
 }
 void GooeyShell_ToggleTitlebar(GooeyShellState *state, Window client)
@@ -2855,13 +3205,16 @@ int GooeyShell_IsTitlebarEnabled(GooeyShellState *state, Window client)
     }
     return (node->is_titlebar_disabled == 0) ? 1 : 0;
 }
-Window *GooeyShell_GetOpenedWindows(GooeyShellState *state, int *count)
+int GooeyShell_GetOpenedWindows(Window *windows, int max_count)
 {
-    if (count != NULL)
+    const OpenedWindowSet *set = AcquireOpenedWindows();
+    int count = (set != NULL) ? set->count : 0;
+    if ((set != NULL) && (windows != NULL) && (max_count > 0))
     {
-        *count = opened_windows_count;
+        memcpy(windows, set->windows, sizeof(Window) * (size_t)((count < max_count) ? count : max_count));
     }
-    return opened_windows;
+    ReleaseOpenedWindows();
+    return count;
 }
 int GooeyShell_IsWindowOpened(GooeyShellState *state, Window window)
 {
@@ -2898,9 +3251,13 @@ void CleanupWorkspace(Workspace *ws)
         }
         free(ws->monitor_tiling_roots);
     }
-    if (ws->stack_ratios != NULL)
+    if (ws->monitor_stack_ratios != NULL)
     {
-        free(ws->stack_ratios);
+        for (i = 0; i < ws->monitor_tiling_roots_count; i++)
+        {
+            free(ws->monitor_stack_ratios[i].ratios);
+        }
+        free(ws->monitor_stack_ratios);
     }
     free(ws);
 }
@@ -2918,8 +3275,14 @@ void GooeyShell_Cleanup(GooeyShellState *state)
     dbus_thread_running = 0;
     if (state->is_dbus_init != 0)
     {
+        WakeDBusThread();
         glps_thread_join(dbus_thread, NULL);
     }
+    if (dbus_wake_fd >= 0)
+    {
+        (void)close(dbus_wake_fd);
+        dbus_wake_fd = -1;
+    }
     if ((state->is_dragging != 0) || (state->is_resizing != 0) || (state->is_tiling_resizing != 0))
     {
         XUngrabPointer(state->display, CurrentTime);
@@ -2944,6 +3307,7 @@ void GooeyShell_Cleanup(GooeyShellState *state)
         {
             XUnmapWindow(state->display, current->client);
         }
+        FreeTitleBarCache(state, current);
         if (current->frame != None)
         {
             XDestroyWindow(state->display, current->frame);
@@ -2952,14 +3316,22 @@ void GooeyShell_Cleanup(GooeyShellState *state)
         current = next_node;
     }
     state->window_list = NULL;
+    state->geometry_queue = NULL;
+    SAFE_FREE(state->tiling_scratch);
+    state->tiling_scratch_capacity = 0;
+    SAFE_FREE(state->layout_rects);
+    SAFE_FREE(state->layout_items);
+    SAFE_FREE(state->layout_boxes);
+    state->layout_rect_capacity = 0;
+    FreeStacking(state);
+    FreeWindowIndex(state);
+    LogObjectPoolStats();
+    FreeObjectPools();
+    FreePendingSignals(state);
+    FreeWindowSnapshot(state);
+    FreeShellStats(state);
     FreeMultiMonitor(state);
-    if (opened_windows != NULL)
-    {
-        free(opened_windows);
-        opened_windows = NULL;
-        opened_windows_count = 0;
-        opened_windows_capacity = 0;
-    }
+    FreeOpenedWindows();
     if (state->dbus_connection != NULL)
     {
         dbus_connection_unref(state->dbus_connection);
@@ -3013,10 +3385,14 @@ void GooeyShell_Cleanup(GooeyShellState *state)
         XFreeCursor(state->display, state->custom_cursor);
         state->custom_cursor = None;
     }
+    CleanupCommandQueue(state);
+    CleanupSpawner(state);
+    CleanupEventLoop(state);
     SAFE_CLOSE_DISPLAY(state->display);
     glps_thread_mutex_destroy(&window_list_mutex);
     glps_thread_mutex_destroy(&dbus_mutex);
     free(state);
+    ShutdownLogger();
 }
 int IgnoreXError(Display *d, XErrorEvent *e)
 {
@@ -3024,29 +3400,34 @@ int IgnoreXError(Display *d, XErrorEvent *e)
     (void)e;
     return 0;
 }
+void RepaintFocusDecorations(GooeyShellState *state, WindowNode *node)
+{
+    if ((state == NULL) || (node == NULL) || (node->frame == None) ||
+        (node->is_desktop_app != 0) || (node->is_fullscreen_app != 0) || (node->is_minimized != 0))
+    {
+        return;
+    }
+    SetWindowBorderColor(state, node,
+                         (state->focused_window == node->frame) ? state->focused_border_color : state->border_color);
+    if (node->is_titlebar_disabled == 0)
+    {
+        DrawTitleBar(state, node);
+    }
+}
 void FocusRootWindow(GooeyShellState *state)
 {
-    WindowNode *current = NULL;
+    WindowNode *previous = NULL;
     if (ValidateWindowState(state) == 0)
     {
         return;
     }
-    current = state->window_list;
-    while (current != NULL)
+    if (state->focused_window != None)
     {
-        if ((current->frame != None) &&
-            (current->is_desktop_app == 0) && (current->is_fullscreen_app == 0) &&
-            (current->is_minimized == 0))
-        {
-            XSetWindowBorder(state->display, current->frame, state->border_color);
-            if (current->is_titlebar_disabled == 0)
-            {
-                DrawTitleBar(state, current);
-            }
-        }
-        current = current->next;
+        previous = FindWindowNodeByFrame(state, state->focused_window);
     }
     state->focused_window = None;
+    state->snapshot_dirty = 1;
+    RepaintFocusDecorations(state, previous);
     XSetInputFocus(state->display, state->root, RevertToPointerRoot, CurrentTime);
 }
 void HandleMouseFocus(GooeyShellState *state, XMotionEvent *ev)
@@ -4,6 +4,8 @@
 #include <X11/Xatom.h>
 #include <dbus/dbus.h>
 #include <GLPS/glps_thread.h>
+#include <stdatomic.h>
+#include "gooey_shell_layout.h"
 #define WINDOW_MANAGER_NAME "GooeyShell"
 #define CONFIG_FILE "~/.config/gooey_shell/config"
 #define BAR_HEIGHT 50
@@ -16,18 +18,56 @@
 #define DEFAULT_WIDTH 800
 #define DEFAULT_HEIGHT 600
 #define WINDOW_OPACITY 0.95f
+#define MAX_SHELL_FD_WATCHES 64
+#define MAX_SHELL_TIMERS 32
+#define MAX_SHELL_CHILDREN 32
+#define SHELL_COMMAND_QUEUE_SIZE 256
+#define SHELL_ERROR_QUEUE_FULL "dev.binaryink.gshell.Error.QueueFull"
+#define MAX_SNAPSHOT_REMOVALS 256
+#define MAX_RETIRED_WINDOW_SETS 16
+#define STATS_SUB_BUCKET_BITS 3
+#define STATS_SUB_BUCKETS (1 << STATS_SUB_BUCKET_BITS)
+#define STATS_BUCKETS 312
+#define MAX_DBUS_STAT_METHODS 16
+#define TRACE_RING_SIZE 8192
+#define WINDOW_SNAPSHOT_SIGNATURE "(tsiiu)"
+#define WINDOW_SNAPSHOT_MINIMIZED (1U << 0)
+#define WINDOW_SNAPSHOT_FLOATING (1U << 1)
+#define WINDOW_SNAPSHOT_FULLSCREEN (1U << 2)
+#define WINDOW_SNAPSHOT_FOCUSED (1U << 3)
+#define WINDOW_SNAPSHOT_FULLSCREEN_APP (1U << 4)
+#define MAX_COMPILED_KEYBINDS 32
+#define DEFAULT_MOTION_COMMIT_RATE 60
 typedef enum
 {
-    LAYOUT_TILING,
-    LAYOUT_MONOCLE,
-    LAYOUT_FLOATING
-} LayoutMode;
+    SHELL_POOL_TILING_NODE,
+    SHELL_POOL_WINDOW_NODE,
+    SHELL_POOL_COUNT
+} ShellPoolType;
 typedef enum
 {
-    SPLIT_NONE,
-    SPLIT_VERTICAL,
-    SPLIT_HORIZONTAL
-} SplitDirection;
+    STACK_LAYER_DESKTOP,
+    STACK_LAYER_NORMAL,
+    STACK_LAYER_FLOATING,
+    STACK_LAYER_ABOVE,
+    STACK_LAYER_FULLSCREEN_APP
+} StackLayer;
+typedef struct StackEntry
+{
+    Window frame;
+    StackLayer layer;
+    long seq;
+} StackEntry;
+typedef struct WindowGeometryState
+{
+    int valid;
+    int frame_x, frame_y;
+    int frame_width, frame_height;
+    int client_x, client_y;
+    int client_width, client_height;
+    int border_valid;
+    unsigned long border_color;
+} WindowGeometryState;
 typedef struct WindowNode
 {
     Window frame;
@@ -49,9 +89,46 @@ typedef struct WindowNode
     int tiling_width, tiling_height;
     int floating_x, floating_y;
     int floating_width, floating_height;
+    int min_width, min_height;
+    int max_width, max_height;
+    WindowGeometryState committed_geometry;
+    int geometry_queued;
+    struct WindowNode *next_queued;
+    long stack_seq;
+    Pixmap title_pixmap;
+    int title_pixmap_width;
+    int title_pixmap_focused;
+    char *title_pixmap_title;
+    struct TilingNode *tiling_leaf;
     struct WindowNode *next;
     struct WindowNode *prev;
 } WindowNode;
+typedef struct WindowProbe
+{
+    int valid;
+    int x, y;
+    int width, height;
+    int override_redirect;
+    int has_desktop_property;
+    int has_fullscreen_property;
+    int has_stay_on_top_property;
+    Atom window_type;
+    int min_width, min_height;
+    int max_width, max_height;
+    char *title;
+    char *res_name;
+} WindowProbe;
+typedef struct LayoutRect
+{
+    WindowNode *window;
+    int x, y;
+    int width, height;
+} LayoutRect;
+typedef struct WindowIndexEntry
+{
+    Window key;
+    WindowNode *node;
+} WindowIndexEntry;
 typedef struct TilingNode
 {
     WindowNode *window;
@@ -70,6 +147,8 @@ typedef struct Monitor
     int x, y;
     int width, height;
     int number;
+    int refresh_rate;
+    XID crtc;
 } Monitor;
 typedef struct MonitorInfo
 {
@@ -86,6 +165,9 @@ typedef struct KeybindConfig
     char *focus_previous_window;
     char *set_tiling_layout;
     char *set_monocle_layout;
+    char *set_master_stack_layout;
+    char *set_grid_layout;
+    char *set_columns_layout;
     char *shrink_width;
     char *grow_width;
     char *shrink_height;
@@ -97,6 +179,42 @@ typedef struct KeybindConfig
     char *logout;
     char *switch_workspace[9];
 } KeybindConfig;
+typedef enum
+{
+    KEY_ACTION_NONE,
+    KEY_ACTION_LAUNCH_TERMINAL,
+    KEY_ACTION_CLOSE_WINDOW,
+    KEY_ACTION_TOGGLE_FLOATING,
+    KEY_ACTION_FOCUS_NEXT_WINDOW,
+    KEY_ACTION_FOCUS_PREVIOUS_WINDOW,
+    KEY_ACTION_SET_TILING_LAYOUT,
+    KEY_ACTION_SET_MONOCLE_LAYOUT,
+    KEY_ACTION_SET_MASTER_STACK_LAYOUT,
+    KEY_ACTION_SET_GRID_LAYOUT,
+    KEY_ACTION_SET_COLUMNS_LAYOUT,
+    KEY_ACTION_SHRINK_WIDTH,
+    KEY_ACTION_GROW_WIDTH,
+    KEY_ACTION_SHRINK_HEIGHT,
+    KEY_ACTION_GROW_HEIGHT,
+    KEY_ACTION_TOGGLE_LAYOUT,
+    KEY_ACTION_MOVE_WINDOW_PREV_MONITOR,
+    KEY_ACTION_MOVE_WINDOW_NEXT_MONITOR,
+    KEY_ACTION_LAUNCH_MENU,
+    KEY_ACTION_LOGOUT,
+    KEY_ACTION_SWITCH_WORKSPACE
+} KeyAction;
+typedef struct CompiledKeybind
+{
+    unsigned int mod_mask;
+    KeyAction action;
+    int arg;
+    int next;
+} CompiledKeybind;
+typedef struct StackRatios
+{
+    float *ratios;
+    int count;
+} StackRatios;
 typedef struct Workspace
 {
     int number;
@@ -104,8 +222,7 @@ typedef struct Workspace
     WindowNode *windows;
     struct Workspace *next;
     float master_ratio;
-    float *stack_ratios;
-    int stack_ratios_count;
+    StackRatios *monitor_stack_ratios;
     TilingNode **monitor_tiling_roots;
     int monitor_tiling_roots_count;
 } Workspace;
@@ -134,6 +251,105 @@ typedef struct PrecomputedAtoms
     Atom gooey_desktop_app;
     Atom net_wm_window_opacity;
 } PrecomputedAtoms;
+struct GooeyShellState;
+typedef void (*ShellFdCallback)(struct GooeyShellState *state, int fd, unsigned int events, void *data);
+typedef void (*ShellTimerCallback)(struct GooeyShellState *state, void *data);
+typedef struct ShellFdWatch
+{
+    int fd;
+    ShellFdCallback callback;
+    void *data;
+} ShellFdWatch;
+typedef struct ShellTimer
+{
+    unsigned long long deadline_ns;
+    ShellTimerCallback callback;
+    void *data;
+    int active;
+} ShellTimer;
+typedef void (*ShellChildCallback)(struct GooeyShellState *state, pid_t pid, int status, void *data);
+typedef struct ShellChild
+{
+    pid_t pid;
+    int pidfd;
+    ShellChildCallback on_exit;
+    void *data;
+} ShellChild;
+typedef struct SupervisedProcess
+{
+    int monitor_number;
+    pid_t pid;
+    Window window;
+    int restart_count;
+    int last_exit_status;
+    int restart_timer;
+    int backoff_ms;
+    unsigned long long started_ns;
+} SupervisedProcess;
+typedef struct TraceEvent
+{
+    const char *name;
+    unsigned long long start_ns;
+    unsigned long long duration_ns;
+    Window window;
+} TraceEvent;
+typedef struct LatencyHistogram
+{
+    atomic_ulong count;
+    atomic_ulong sum_ns;
+    atomic_ulong max_ns;
+    atomic_ulong requests;
+    atomic_ulong buckets[STATS_BUCKETS];
+} LatencyHistogram;
+typedef struct OpenedWindowSet
+{
+    int count;
+    Window windows[];
+} OpenedWindowSet;
+typedef struct WindowSnapshotEntry
+{
+    unsigned long long id;
+    char *title;
+    int workspace;
+    int monitor;
+    unsigned int flags;
+    unsigned long long generation;
+} WindowSnapshotEntry;
+typedef struct WindowSnapshotRemoval
+{
+    unsigned long long id;
+    unsigned long long generation;
+} WindowSnapshotRemoval;
+typedef struct WindowStateDelta
+{
+    Window window;
+    const char *state_str;
+    int opened;
+} WindowStateDelta;
+typedef enum
+{
+    SHELL_COMMAND_MINIMIZE,
+    SHELL_COMMAND_RESTORE,
+    SHELL_COMMAND_CLOSE,
+    SHELL_COMMAND_TOGGLE_TILING,
+    SHELL_COMMAND_FOCUS_NEXT,
+    SHELL_COMMAND_FOCUS_PREVIOUS,
+    SHELL_COMMAND_SET_WALLPAPER,
+    SHELL_COMMAND_RESET_STATS,
+    SHELL_COMMAND_DUMP_TRACE,
+    SHELL_COMMAND_COUNT
+} ShellCommandType;
+typedef struct ShellCommand
+{
+    ShellCommandType type;
+    Window window;
+    char *argument;
+} ShellCommand;
+typedef struct ShellCommandSlot
+{
+    atomic_size_t sequence;
+    ShellCommand command;
+} ShellCommandSlot;
 typedef struct GooeyShellState
 {
     Display *display;
@@ -152,9 +368,23 @@ typedef struct GooeyShellState
     int drag_start_x, drag_start_y;
     int original_x, original_y;
     int original_width, original_height;
+    XMotionEvent pending_motion;
+    int has_pending_motion;
+    int motion_commit_timer;
+    int motion_commit_rate;
+    unsigned long long last_motion_commit_ns;
+    unsigned long motion_events_dropped;
+    unsigned long motion_events_committed;
     Workspace *workspaces;
     int current_workspace;
     LayoutMode current_layout;
+    WindowNode *tiling_focus;
+    WindowNode **tiling_scratch;
+    int tiling_scratch_capacity;
+    LayoutRect *layout_rects;
+    LayoutItem *layout_items;
+    LayoutBox *layout_boxes;
+    int layout_rect_capacity;
     MonitorInfo monitor_info;
     int focused_monitor;
     GC gc;
@@ -179,6 +409,9 @@ typedef struct GooeyShellState
     Cursor custom_cursor;
     char *config_file;
     KeybindConfig keybinds;
+    CompiledKeybind compiled_keybinds[MAX_COMPILED_KEYBINDS];
+    int compiled_keybind_count;
+    int keybind_heads[256];
     char *logout_command;
     int inner_gap;
     int outer_gap;
@@ -189,8 +422,77 @@ typedef struct GooeyShellState
     int is_dbus_init;
     int supports_opacity;
     char *custom_scripts[256];
+    int is_running;
+    int epoll_fd;
+    int signal_fd;
+    int timer_fd;
+    ShellFdWatch fd_watches[MAX_SHELL_FD_WATCHES];
+    ShellTimer timers[MAX_SHELL_TIMERS];
+    int wallpaper_announce_attempts;
+    WindowIndexEntry *window_index;
+    int window_index_capacity;
+    int window_index_count;
+    WindowNode *geometry_queue;
+    unsigned long geometry_requests_sent;
+    long stack_seq_top;
+    long stack_seq_bottom;
+    StackEntry *stack_entries;
+    Window *desired_stack;
+    Window *committed_stack;
+    int stack_capacity;
+    int committed_stack_count;
+    int focus_signal_pending;
+    int has_randr;
+    int randr_event_base;
+    int monitor_refresh_pending;
+    SupervisedProcess *desktop_apps;
+    int desktop_app_count;
+    ShellChild children[MAX_SHELL_CHILDREN];
+    int untracked_children;
+    ShellCommandSlot command_slots[SHELL_COMMAND_QUEUE_SIZE];
+    atomic_size_t command_head;
+    atomic_size_t command_tail;
+    atomic_ulong command_queue_overflows;
+    int command_event_fd;
+    WindowStateDelta *pending_window_states;
+    int pending_window_state_count;
+    int pending_window_state_capacity;
+    int workspace_signal_pending;
+    int pending_workspace_old;
+    int pending_workspace_new;
+    int snapshot_dirty;
+    unsigned long long snapshot_generation;
+    WindowSnapshotEntry *snapshot_entries;
+    int snapshot_count;
+    WindowSnapshotRemoval snapshot_removals[MAX_SNAPSHOT_REMOVALS];
+    int snapshot_removal_count;
+    int snapshot_removal_next;
+    unsigned long long snapshot_history_start;
+    LatencyHistogram event_stats[LASTEvent + 1];
+    LatencyHistogram command_stats[SHELL_COMMAND_COUNT];
+    LatencyHistogram layout_stats[LAYOUT_COUNT];
+    LatencyHistogram dbus_stats[MAX_DBUS_STAT_METHODS];
+    char *dbus_stat_names[MAX_DBUS_STAT_METHODS];
+    int dbus_stat_count;
+    TraceEvent trace_events[TRACE_RING_SIZE];
+    unsigned long trace_count;
+    unsigned long last_flush_request;
 } GooeyShellState;
+#include "gooey_shell_log.h"
 #include "gooey_shell_core.h"
 #include "gooey_shell_tiling.h"
 #include "gooey_shell_config.h"
+#include "gooey_shell_loop.h"
+#include "gooey_shell_geometry.h"
+#include "gooey_shell_probe.h"
+#include "gooey_shell_stack.h"
+#include "gooey_shell_randr.h"
+#include "gooey_shell_spawn.h"
+#include "gooey_shell_supervisor.h"
+#include "gooey_shell_command.h"
+#include "gooey_shell_signals.h"
+#include "gooey_shell_snapshot.h"
+#include "gooey_shell_stats.h"
+#include "gooey_shell_trace.h"
+#include "gooey_shell_pool.h"
 #endif
\ No newline at end of file
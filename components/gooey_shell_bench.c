@@ -0,0 +1,889 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/keysym.h>
+#include <X11/extensions/XTest.h>
+#include <dbus/dbus.h>
+
+#define DBUS_SERVICE "dev.binaryink.gshell"
+#define DBUS_PATH "/dev/binaryink/gshell"
+#define DBUS_INTERFACE "dev.binaryink.gshell"
+#define BENCH_STARTUP_TIMEOUT_MS 10000
+#define BENCH_EVENT_TIMEOUT_MS 2000
+#define BENCH_DEFAULT_ITERATIONS 50
+#define BENCH_MAX_WINDOW_COUNTS 8
+#define BENCH_WINDOW_WIDTH 400
+#define BENCH_WINDOW_HEIGHT 300
+
+extern char **environ;
+
+typedef enum
+{
+    BENCH_METRIC_MAP,
+    BENCH_METRIC_RETILE,
+    BENCH_METRIC_FOCUS_NEXT,
+    BENCH_METRIC_WORKSPACE_SWITCH,
+    BENCH_METRIC_CLOSE,
+    BENCH_METRIC_COUNT
+} BenchMetric;
+
+typedef struct
+{
+    unsigned long long *values;
+    int count;
+    int capacity;
+    int timeouts;
+} BenchSamples;
+
+typedef struct
+{
+    char category[16];
+    char name[64];
+    unsigned long long count;
+    unsigned long long mean_ns;
+    unsigned long long p50_ns;
+    unsigned long long p99_ns;
+    unsigned long long max_ns;
+    unsigned long long requests;
+} BenchShellStat;
+
+typedef struct
+{
+    const char *shell_path;
+    int iterations;
+    pid_t xvfb_pid;
+    pid_t dbus_pid;
+    pid_t shell_pid;
+    char display_name[32];
+    char bus_address[512];
+    char home_dir[64];
+    Display *display;
+    Window root;
+    Atom wm_protocols;
+    Atom wm_delete_window;
+    DBusConnection *bus;
+    Window *windows;
+    int window_count;
+    BenchSamples samples[BENCH_METRIC_COUNT];
+    BenchShellStat *shell_stats;
+    int shell_stat_count;
+} BenchContext;
+
+static const char *metric_names[BENCH_METRIC_COUNT] = {
+    "map_latency",
+    "retile",
+    "focus_next",
+    "workspace_switch",
+    "close"};
+
+static unsigned long long BenchNowNs(void)
+{
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((unsigned long long)ts.tv_sec * 1000000000ULL) + (unsigned long long)ts.tv_nsec;
+}
+static int RemainingMs(unsigned long long deadline_ns)
+{
+    unsigned long long now = BenchNowNs();
+    if (now >= deadline_ns)
+    {
+        return 0;
+    }
+    return (int)((deadline_ns - now + 999999ULL) / 1000000ULL);
+}
+static void AddSample(BenchSamples *samples, unsigned long long value)
+{
+    if (samples->count == samples->capacity)
+    {
+        int capacity = (samples->capacity == 0) ? 64 : samples->capacity * 2;
+        unsigned long long *values = realloc(samples->values, (size_t)capacity * sizeof(*values));
+        if (values == NULL)
+        {
+            return;
+        }
+        samples->values = values;
+        samples->capacity = capacity;
+    }
+    samples->values[samples->count] = value;
+    samples->count++;
+}
+static int CompareSamples(const void *a, const void *b)
+{
+    unsigned long long left = *(const unsigned long long *)a;
+    unsigned long long right = *(const unsigned long long *)b;
+    return (left < right) ? -1 : ((left > right) ? 1 : 0);
+}
+static unsigned long long Percentile(const BenchSamples *samples, int percent)
+{
+    int index = 0;
+    if (samples->count == 0)
+    {
+        return 0ULL;
+    }
+    index = (samples->count * percent + 99) / 100 - 1;
+    if (index < 0)
+    {
+        index = 0;
+    }
+    return samples->values[index];
+}
+static void ResetSamples(BenchContext *ctx)
+{
+    int i = 0;
+    for (i = 0; i < BENCH_METRIC_COUNT; i++)
+    {
+        free(ctx->samples[i].values);
+        memset(&ctx->samples[i], 0, sizeof(ctx->samples[i]));
+    }
+    free(ctx->shell_stats);
+    ctx->shell_stats = NULL;
+    ctx->shell_stat_count = 0;
+}
+static pid_t SpawnWithReportFd(char *const argv[], int *report_fd)
+{
+    posix_spawn_file_actions_t actions;
+    pid_t pid = -1;
+    int fds[2] = {-1, -1};
+    int result = 0;
+    if (report_fd != NULL)
+    {
+        if (pipe2(fds, O_CLOEXEC) != 0)
+        {
+            fprintf(stderr, "SpawnWithReportFd: pipe2 failed: %s\n", strerror(errno));
+            return -1;
+        }
+    }
+    posix_spawn_file_actions_init(&actions);
+    if (report_fd != NULL)
+    {
+        posix_spawn_file_actions_adddup2(&actions, fds[1], 3);
+    }
+    result = posix_spawnp(&pid, argv[0], &actions, NULL, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (report_fd != NULL)
+    {
+        (void)close(fds[1]);
+        if (result != 0)
+        {
+            (void)close(fds[0]);
+        }
+        else
+        {
+            *report_fd = fds[0];
+        }
+    }
+    if (result != 0)
+    {
+        fprintf(stderr, "SpawnWithReportFd: Failed to start %s: %s\n", argv[0], strerror(result));
+        return -1;
+    }
+    return pid;
+}
+static int ReadReportLine(int fd, char *buffer, size_t size, int timeout_ms)
+{
+    unsigned long long deadline = BenchNowNs() + (unsigned long long)timeout_ms * 1000000ULL;
+    size_t length = 0;
+    while (length + 1 < size)
+    {
+        struct pollfd pfd;
+        ssize_t n = 0;
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, RemainingMs(deadline)) <= 0)
+        {
+            break;
+        }
+        n = read(fd, buffer + length, 1);
+        if (n <= 0)
+        {
+            break;
+        }
+        if (buffer[length] == '\n')
+        {
+            break;
+        }
+        length++;
+    }
+    buffer[length] = '\0';
+    (void)close(fd);
+    return (length > 0) ? 1 : 0;
+}
+static void StopProcess(pid_t *pid)
+{
+    unsigned long long deadline = 0ULL;
+    if (*pid <= 0)
+    {
+        return;
+    }
+    (void)kill(*pid, SIGTERM);
+    deadline = BenchNowNs() + 2000000000ULL;
+    while (waitpid(*pid, NULL, WNOHANG) == 0)
+    {
+        if (RemainingMs(deadline) == 0)
+        {
+            (void)kill(*pid, SIGKILL);
+            (void)waitpid(*pid, NULL, 0);
+            break;
+        }
+        (void)usleep(10000);
+    }
+    *pid = -1;
+}
+static int StartXvfb(BenchContext *ctx)
+{
+    char *argv[] = {"Xvfb", "-displayfd", "3", "-screen", "0", "1920x1080x24", "-nolisten", "tcp", NULL};
+    char number[16];
+    int report_fd = -1;
+    ctx->xvfb_pid = SpawnWithReportFd(argv, &report_fd);
+    if (ctx->xvfb_pid < 0)
+    {
+        return 0;
+    }
+    if (ReadReportLine(report_fd, number, sizeof(number), BENCH_STARTUP_TIMEOUT_MS) == 0)
+    {
+        fprintf(stderr, "StartXvfb: Xvfb did not report a display\n");
+        return 0;
+    }
+    (void)snprintf(ctx->display_name, sizeof(ctx->display_name), ":%s", number);
+    ctx->display = XOpenDisplay(ctx->display_name);
+    if (ctx->display == NULL)
+    {
+        fprintf(stderr, "StartXvfb: Cannot open display %s\n", ctx->display_name);
+        return 0;
+    }
+    ctx->root = DefaultRootWindow(ctx->display);
+    ctx->wm_protocols = XInternAtom(ctx->display, "WM_PROTOCOLS", False);
+    ctx->wm_delete_window = XInternAtom(ctx->display, "WM_DELETE_WINDOW", False);
+    (void)setenv("DISPLAY", ctx->display_name, 1);
+    return 1;
+}
+static int StartDBus(BenchContext *ctx)
+{
+    char *argv[] = {"dbus-daemon", "--session", "--nofork", "--nopidfile", "--print-address=3", NULL};
+    DBusError error;
+    int report_fd = -1;
+    ctx->dbus_pid = SpawnWithReportFd(argv, &report_fd);
+    if (ctx->dbus_pid < 0)
+    {
+        return 0;
+    }
+    if (ReadReportLine(report_fd, ctx->bus_address, sizeof(ctx->bus_address), BENCH_STARTUP_TIMEOUT_MS) == 0)
+    {
+        fprintf(stderr, "StartDBus: dbus-daemon did not report an address\n");
+        return 0;
+    }
+    (void)setenv("DBUS_SESSION_BUS_ADDRESS", ctx->bus_address, 1);
+    dbus_error_init(&error);
+    ctx->bus = dbus_connection_open_private(ctx->bus_address, &error);
+    if ((ctx->bus == NULL) || (dbus_bus_register(ctx->bus, &error) == FALSE))
+    {
+        fprintf(stderr, "StartDBus: Cannot connect to %s: %s\n", ctx->bus_address,
+                (dbus_error_is_set(&error) != 0) ? error.message : "unknown error");
+        dbus_error_free(&error);
+        return 0;
+    }
+    dbus_bus_add_match(ctx->bus, "type='signal',interface='" DBUS_INTERFACE "'", &error);
+    if (dbus_error_is_set(&error) != 0)
+    {
+        fprintf(stderr, "StartDBus: add_match failed: %s\n", error.message);
+        dbus_error_free(&error);
+        return 0;
+    }
+    return 1;
+}
+static int StartShell(BenchContext *ctx)
+{
+    char *argv[] = {(char *)ctx->shell_path, NULL};
+    unsigned long long deadline = 0ULL;
+    DBusError error;
+    (void)setenv("GOOEY_LOG_LEVEL", "error", 0);
+    ctx->shell_pid = SpawnWithReportFd(argv, NULL);
+    if (ctx->shell_pid < 0)
+    {
+        return 0;
+    }
+    dbus_error_init(&error);
+    deadline = BenchNowNs() + (unsigned long long)BENCH_STARTUP_TIMEOUT_MS * 1000000ULL;
+    while (RemainingMs(deadline) > 0)
+    {
+        if (waitpid(ctx->shell_pid, NULL, WNOHANG) == ctx->shell_pid)
+        {
+            fprintf(stderr, "StartShell: %s exited during startup\n", ctx->shell_path);
+            ctx->shell_pid = -1;
+            return 0;
+        }
+        if (dbus_bus_name_has_owner(ctx->bus, DBUS_SERVICE, &error) != FALSE)
+        {
+            return 1;
+        }
+        if (dbus_error_is_set(&error) != 0)
+        {
+            dbus_error_free(&error);
+        }
+        (void)usleep(20000);
+    }
+    fprintf(stderr, "StartShell: %s did not register %s\n", ctx->shell_path, DBUS_SERVICE);
+    return 0;
+}
+static void DrainXEvents(BenchContext *ctx)
+{
+    XEvent ev;
+    XSync(ctx->display, False);
+    while (XPending(ctx->display) > 0)
+    {
+        XNextEvent(ctx->display, &ev);
+    }
+}
+static void DrainBus(BenchContext *ctx)
+{
+    DBusMessage *msg = NULL;
+    (void)dbus_connection_read_write(ctx->bus, 0);
+    while ((msg = dbus_connection_pop_message(ctx->bus)) != NULL)
+    {
+        dbus_message_unref(msg);
+    }
+}
+static void Settle(BenchContext *ctx)
+{
+    XSync(ctx->display, False);
+    (void)usleep(50000);
+    DrainXEvents(ctx);
+    DrainBus(ctx);
+}
+static int WaitForXEvent(BenchContext *ctx, int type, Window window, XEvent *out, int timeout_ms)
+{
+    unsigned long long deadline = BenchNowNs() + (unsigned long long)timeout_ms * 1000000ULL;
+    for (;;)
+    {
+        struct pollfd pfd;
+        while (XPending(ctx->display) > 0)
+        {
+            XNextEvent(ctx->display, out);
+            if ((out->type == type) && ((window == None) || (out->xany.window == window)))
+            {
+                return 1;
+            }
+        }
+        if (RemainingMs(deadline) == 0)
+        {
+            return 0;
+        }
+        pfd.fd = ConnectionNumber(ctx->display);
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        (void)poll(&pfd, 1, RemainingMs(deadline));
+    }
+}
+static int SignalMatches(DBusMessage *msg, const char *member, const char *state_filter)
+{
+    const char *window_str = NULL;
+    const char *state_str = NULL;
+    if (dbus_message_is_signal(msg, DBUS_INTERFACE, member) == FALSE)
+    {
+        return 0;
+    }
+    if (state_filter == NULL)
+    {
+        return 1;
+    }
+    if (dbus_message_get_args(msg, NULL, DBUS_TYPE_STRING, &window_str,
+                              DBUS_TYPE_STRING, &state_str, DBUS_TYPE_INVALID) == FALSE)
+    {
+        return 0;
+    }
+    return (strcmp(state_str, state_filter) == 0) ? 1 : 0;
+}
+static int WaitForSignal(BenchContext *ctx, const char *member, const char *state_filter, int timeout_ms)
+{
+    unsigned long long deadline = BenchNowNs() + (unsigned long long)timeout_ms * 1000000ULL;
+    for (;;)
+    {
+        DBusMessage *msg = NULL;
+        while ((msg = dbus_connection_pop_message(ctx->bus)) != NULL)
+        {
+            int matched = SignalMatches(msg, member, state_filter);
+            dbus_message_unref(msg);
+            if (matched != 0)
+            {
+                return 1;
+            }
+        }
+        if (RemainingMs(deadline) == 0)
+        {
+            return 0;
+        }
+        if (dbus_connection_read_write(ctx->bus, RemainingMs(deadline)) == FALSE)
+        {
+            return 0;
+        }
+    }
+}
+static DBusMessage *CallShell(BenchContext *ctx, const char *method)
+{
+    DBusMessage *msg = NULL;
+    DBusMessage *reply = NULL;
+    DBusError error;
+    msg = dbus_message_new_method_call(DBUS_SERVICE, DBUS_PATH, DBUS_INTERFACE, method);
+    if (msg == NULL)
+    {
+        return NULL;
+    }
+    dbus_error_init(&error);
+    reply = dbus_connection_send_with_reply_and_block(ctx->bus, msg, BENCH_EVENT_TIMEOUT_MS, &error);
+    dbus_message_unref(msg);
+    if (reply == NULL)
+    {
+        fprintf(stderr, "CallShell: %s failed: %s\n", method,
+                (dbus_error_is_set(&error) != 0) ? error.message : "no reply");
+        dbus_error_free(&error);
+    }
+    return reply;
+}
+static void FetchShellStats(BenchContext *ctx)
+{
+    DBusMessage *reply = CallShell(ctx, "GetStats");
+    DBusMessageIter args;
+    DBusMessageIter array_iter;
+    if (reply == NULL)
+    {
+        return;
+    }
+    if ((dbus_message_iter_init(reply, &args) == FALSE) ||
+        (dbus_message_iter_get_arg_type(&args) != DBUS_TYPE_ARRAY))
+    {
+        dbus_message_unref(reply);
+        return;
+    }
+    dbus_message_iter_recurse(&args, &array_iter);
+    while (dbus_message_iter_get_arg_type(&array_iter) == DBUS_TYPE_STRUCT)
+    {
+        DBusMessageIter entry;
+        BenchShellStat stat;
+        const char *category = NULL;
+        const char *name = NULL;
+        dbus_uint64_t values[6];
+        BenchShellStat *grown = NULL;
+        int i = 0;
+        dbus_message_iter_recurse(&array_iter, &entry);
+        dbus_message_iter_get_basic(&entry, &category);
+        dbus_message_iter_next(&entry);
+        dbus_message_iter_get_basic(&entry, &name);
+        for (i = 0; i < 6; i++)
+        {
+            dbus_message_iter_next(&entry);
+            dbus_message_iter_get_basic(&entry, &values[i]);
+        }
+        dbus_message_iter_next(&array_iter);
+        if (values[0] == 0)
+        {
+            continue;
+        }
+        memset(&stat, 0, sizeof(stat));
+        (void)snprintf(stat.category, sizeof(stat.category), "%s", category);
+        (void)snprintf(stat.name, sizeof(stat.name), "%s", name);
+        stat.count = values[0];
+        stat.mean_ns = values[1];
+        stat.p50_ns = values[2];
+        stat.p99_ns = values[3];
+        stat.max_ns = values[4];
+        stat.requests = values[5];
+        grown = realloc(ctx->shell_stats, (size_t)(ctx->shell_stat_count + 1) * sizeof(*grown));
+        if (grown == NULL)
+        {
+            break;
+        }
+        ctx->shell_stats = grown;
+        ctx->shell_stats[ctx->shell_stat_count] = stat;
+        ctx->shell_stat_count++;
+    }
+    dbus_message_unref(reply);
+}
+static void SendKeyCombo(BenchContext *ctx, KeySym keysym)
+{
+    KeyCode modifier = XKeysymToKeycode(ctx->display, XK_Alt_L);
+    KeyCode key = XKeysymToKeycode(ctx->display, keysym);
+    XTestFakeKeyEvent(ctx->display, modifier, True, CurrentTime);
+    XTestFakeKeyEvent(ctx->display, key, True, CurrentTime);
+    XTestFakeKeyEvent(ctx->display, key, False, CurrentTime);
+    XTestFakeKeyEvent(ctx->display, modifier, False, CurrentTime);
+    XFlush(ctx->display);
+}
+static int IsBenchWindow(BenchContext *ctx, Window window)
+{
+    int i = 0;
+    for (i = 0; i < ctx->window_count; i++)
+    {
+        if (ctx->windows[i] == window)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+static void RemoveBenchWindow(BenchContext *ctx, int index)
+{
+    XDestroyWindow(ctx->display, ctx->windows[index]);
+    ctx->windows[index] = ctx->windows[ctx->window_count - 1];
+    ctx->window_count--;
+}
+static void RunMapPhase(BenchContext *ctx, int count)
+{
+    BenchSamples *samples = &ctx->samples[BENCH_METRIC_MAP];
+    int i = 0;
+    ctx->windows = calloc((size_t)count, sizeof(Window));
+    if (ctx->windows == NULL)
+    {
+        return;
+    }
+    for (i = 0; i < count; i++)
+    {
+        Window window = XCreateSimpleWindow(ctx->display, ctx->root, 0, 0,
+                                            BENCH_WINDOW_WIDTH, BENCH_WINDOW_HEIGHT, 0, 0, 0);
+        char title[32];
+        unsigned long long start = 0ULL;
+        XEvent ev;
+        (void)snprintf(title, sizeof(title), "bench-%d", i);
+        XStoreName(ctx->display, window, title);
+        XSetWMProtocols(ctx->display, window, &ctx->wm_delete_window, 1);
+        XSelectInput(ctx->display, window, StructureNotifyMask);
+        ctx->windows[ctx->window_count] = window;
+        ctx->window_count++;
+        start = BenchNowNs();
+        XMapWindow(ctx->display, window);
+        XFlush(ctx->display);
+        if (WaitForXEvent(ctx, MapNotify, window, &ev, BENCH_EVENT_TIMEOUT_MS) != 0)
+        {
+            AddSample(samples, BenchNowNs() - start);
+        }
+        else
+        {
+            samples->timeouts++;
+        }
+    }
+}
+static void RunRetilePhase(BenchContext *ctx)
+{
+    BenchSamples *samples = &ctx->samples[BENCH_METRIC_RETILE];
+    int i = 0;
+    SendKeyCombo(ctx, XK_t);
+    Settle(ctx);
+    for (i = 0; i < ctx->iterations; i++)
+    {
+        unsigned long long start = BenchNowNs();
+        XEvent ev;
+        SendKeyCombo(ctx, ((i % 2) == 0) ? XK_l : XK_h);
+        if (WaitForXEvent(ctx, ConfigureNotify, None, &ev, BENCH_EVENT_TIMEOUT_MS) != 0)
+        {
+            AddSample(samples, BenchNowNs() - start);
+        }
+        else
+        {
+            samples->timeouts++;
+        }
+        Settle(ctx);
+    }
+}
+static void RunFocusPhase(BenchContext *ctx)
+{
+    BenchSamples *samples = &ctx->samples[BENCH_METRIC_FOCUS_NEXT];
+    int i = 0;
+    for (i = 0; i < ctx->iterations; i++)
+    {
+        unsigned long long start = BenchNowNs();
+        SendKeyCombo(ctx, XK_j);
+        if (WaitForSignal(ctx, "WindowStateChanged", "focused", BENCH_EVENT_TIMEOUT_MS) != 0)
+        {
+            AddSample(samples, BenchNowNs() - start);
+        }
+        else
+        {
+            samples->timeouts++;
+        }
+        Settle(ctx);
+    }
+}
+static void RunWorkspacePhase(BenchContext *ctx)
+{
+    BenchSamples *samples = &ctx->samples[BENCH_METRIC_WORKSPACE_SWITCH];
+    int i = 0;
+    for (i = 0; i < ctx->iterations * 2; i++)
+    {
+        unsigned long long start = BenchNowNs();
+        SendKeyCombo(ctx, ((i % 2) == 0) ? XK_2 : XK_1);
+        if (WaitForSignal(ctx, "WorkspaceChanged", NULL, BENCH_EVENT_TIMEOUT_MS) != 0)
+        {
+            AddSample(samples, BenchNowNs() - start);
+        }
+        else
+        {
+            samples->timeouts++;
+        }
+        Settle(ctx);
+    }
+}
+static void RunClosePhase(BenchContext *ctx)
+{
+    BenchSamples *samples = &ctx->samples[BENCH_METRIC_CLOSE];
+    while (ctx->window_count > 0)
+    {
+        unsigned long long start = BenchNowNs();
+        XEvent ev;
+        int index = -1;
+        SendKeyCombo(ctx, XK_q);
+        if ((WaitForXEvent(ctx, ClientMessage, None, &ev, BENCH_EVENT_TIMEOUT_MS) != 0) &&
+            (ev.xclient.message_type == ctx->wm_protocols) &&
+            ((Atom)ev.xclient.data.l[0] == ctx->wm_delete_window))
+        {
+            AddSample(samples, BenchNowNs() - start);
+            index = IsBenchWindow(ctx, ev.xclient.window);
+        }
+        else
+        {
+            samples->timeouts++;
+        }
+        RemoveBenchWindow(ctx, (index >= 0) ? index : ctx->window_count - 1);
+        XSync(ctx->display, False);
+        if ((ctx->window_count % 16) == 0)
+        {
+            Settle(ctx);
+        }
+    }
+    free(ctx->windows);
+    ctx->windows = NULL;
+}
+static void PrintSamples(FILE *out, const char *name, BenchSamples *samples, int last)
+{
+    unsigned long long total = 0ULL;
+    int i = 0;
+    qsort(samples->values, (size_t)samples->count, sizeof(*samples->values), CompareSamples);
+    for (i = 0; i < samples->count; i++)
+    {
+        total += samples->values[i];
+    }
+    fprintf(out, "        \"%s\": {\"samples\": %d, \"timeouts\": %d, \"mean_us\": %.1f, "
+                 "\"p50_us\": %.1f, \"p99_us\": %.1f, \"max_us\": %.1f}%s\n",
+            name, samples->count, samples->timeouts,
+            (samples->count > 0) ? (double)total / (double)samples->count / 1000.0 : 0.0,
+            (double)Percentile(samples, 50) / 1000.0,
+            (double)Percentile(samples, 99) / 1000.0,
+            (double)Percentile(samples, 100) / 1000.0,
+            (last != 0) ? "" : ",");
+}
+static void PrintResult(FILE *out, BenchContext *ctx, int count, int first)
+{
+    unsigned long long total_requests = 0ULL;
+    int i = 0;
+    fprintf(out, "%s    {\n      \"windows\": %d,\n      \"client\": {\n", (first != 0) ? "" : ",\n", count);
+    for (i = 0; i < BENCH_METRIC_COUNT; i++)
+    {
+        PrintSamples(out, metric_names[i], &ctx->samples[i], (i == BENCH_METRIC_COUNT - 1) ? 1 : 0);
+    }
+    fprintf(out, "      },\n      \"shell\": [\n");
+    for (i = 0; i < ctx->shell_stat_count; i++)
+    {
+        BenchShellStat *stat = &ctx->shell_stats[i];
+        if (strcmp(stat->category, "layout") != 0)
+        {
+            total_requests += stat->requests;
+        }
+        fprintf(out, "        {\"category\": \"%s\", \"name\": \"%s\", \"count\": %llu, \"mean_ns\": %llu, "
+                     "\"p50_ns\": %llu, \"p99_ns\": %llu, \"max_ns\": %llu, \"x_requests\": %llu}%s\n",
+                stat->category, stat->name, stat->count, stat->mean_ns,
+                stat->p50_ns, stat->p99_ns, stat->max_ns, stat->requests,
+                (i == ctx->shell_stat_count - 1) ? "" : ",");
+    }
+    fprintf(out, "      ],\n      \"x_requests_total\": %llu\n    }", total_requests);
+}
+static int RunBenchmark(BenchContext *ctx, int count)
+{
+    DBusMessage *reply = NULL;
+    ResetSamples(ctx);
+    if (StartShell(ctx) == 0)
+    {
+        StopProcess(&ctx->shell_pid);
+        return 0;
+    }
+    Settle(ctx);
+    reply = CallShell(ctx, "ResetStats");
+    if (reply != NULL)
+    {
+        dbus_message_unref(reply);
+    }
+    Settle(ctx);
+    RunMapPhase(ctx, count);
+    Settle(ctx);
+    RunRetilePhase(ctx);
+    RunFocusPhase(ctx);
+    RunWorkspacePhase(ctx);
+    RunClosePhase(ctx);
+    Settle(ctx);
+    FetchShellStats(ctx);
+    StopProcess(&ctx->shell_pid);
+    return 1;
+}
+static int RemoveTreeEntry(const char *path, const struct stat *sb, int flag, struct FTW *ftw)
+{
+    (void)sb;
+    (void)flag;
+    (void)ftw;
+    (void)remove(path);
+    return 0;
+}
+static void Cleanup(BenchContext *ctx)
+{
+    ResetSamples(ctx);
+    free(ctx->windows);
+    ctx->windows = NULL;
+    StopProcess(&ctx->shell_pid);
+    if (ctx->bus != NULL)
+    {
+        dbus_connection_close(ctx->bus);
+        dbus_connection_unref(ctx->bus);
+        ctx->bus = NULL;
+    }
+    if (ctx->display != NULL)
+    {
+        XCloseDisplay(ctx->display);
+        ctx->display = NULL;
+    }
+    StopProcess(&ctx->dbus_pid);
+    StopProcess(&ctx->xvfb_pid);
+    if (ctx->home_dir[0] != '\0')
+    {
+        (void)nftw(ctx->home_dir, RemoveTreeEntry, 16, FTW_DEPTH | FTW_PHYS);
+    }
+}
+static int ParseWindowCounts(const char *text, int *counts)
+{
+    char *copy = strdup(text);
+    char *saveptr = NULL;
+    char *token = NULL;
+    int n = 0;
+    if (copy == NULL)
+    {
+        return 0;
+    }
+    for (token = strtok_r(copy, ",", &saveptr); (token != NULL) && (n < BENCH_MAX_WINDOW_COUNTS);
+         token = strtok_r(NULL, ",", &saveptr))
+    {
+        int value = atoi(token);
+        if (value > 0)
+        {
+            counts[n] = value;
+            n++;
+        }
+    }
+    free(copy);
+    return n;
+}
+static void PrintUsage(const char *program)
+{
+    fprintf(stderr, "Usage: %s [-s shell] [-n counts] [-i iterations] [-o output]\n", program);
+    fprintf(stderr, "  -s shell       gooey_shell binary to benchmark (default ./gooey_shell)\n");
+    fprintf(stderr, "  -n counts      comma separated window counts (default 10,100,1000)\n");
+    fprintf(stderr, "  -i iterations  samples per interactive metric (default %d)\n", BENCH_DEFAULT_ITERATIONS);
+    fprintf(stderr, "  -o output      write JSON results to a file instead of stdout\n");
+}
+int main(int argc, char **argv)
+{
+    BenchContext ctx;
+    int counts[BENCH_MAX_WINDOW_COUNTS] = {10, 100, 1000};
+    int count_total = 3;
+    const char *output_path = NULL;
+    FILE *out = stdout;
+    int status = 0;
+    int opt = 0;
+    int i = 0;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.shell_path = "./gooey_shell";
+    ctx.iterations = BENCH_DEFAULT_ITERATIONS;
+    ctx.xvfb_pid = -1;
+    ctx.dbus_pid = -1;
+    ctx.shell_pid = -1;
+    while ((opt = getopt(argc, argv, "s:n:i:o:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            ctx.shell_path = optarg;
+            break;
+        case 'n':
+            count_total = ParseWindowCounts(optarg, counts);
+            break;
+        case 'i':
+            ctx.iterations = atoi(optarg);
+            break;
+        case 'o':
+            output_path = optarg;
+            break;
+        default:
+            PrintUsage(argv[0]);
+            return (opt == 'h') ? 0 : 2;
+        }
+    }
+    if ((count_total == 0) || (ctx.iterations <= 0))
+    {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+    (void)snprintf(ctx.home_dir, sizeof(ctx.home_dir), "/tmp/gooey-shell-bench-XXXXXX");
+    if (mkdtemp(ctx.home_dir) == NULL)
+    {
+        fprintf(stderr, "main: mkdtemp failed: %s\n", strerror(errno));
+        return 1;
+    }
+    (void)setenv("HOME", ctx.home_dir, 1);
+    if ((StartXvfb(&ctx) == 0) || (StartDBus(&ctx) == 0))
+    {
+        Cleanup(&ctx);
+        return 1;
+    }
+    if (XTestQueryExtension(ctx.display, &opt, &opt, &opt, &opt) == False)
+    {
+        fprintf(stderr, "main: XTEST extension is not available on %s\n", ctx.display_name);
+        Cleanup(&ctx);
+        return 1;
+    }
+    if (output_path != NULL)
+    {
+        out = fopen(output_path, "w");
+        if (out == NULL)
+        {
+            fprintf(stderr, "main: Cannot open %s: %s\n", output_path, strerror(errno));
+            Cleanup(&ctx);
+            return 1;
+        }
+    }
+    fprintf(out, "{\n  \"benchmark\": \"gooey_shell\",\n  \"iterations\": %d,\n  \"results\": [\n", ctx.iterations);
+    for (i = 0; i < count_total; i++)
+    {
+        if (RunBenchmark(&ctx, counts[i]) == 0)
+        {
+            status = 1;
+            break;
+        }
+        PrintResult(out, &ctx, counts[i], (i == 0) ? 1 : 0);
+        fflush(out);
+    }
+    fprintf(out, "\n  ]\n}\n");
+    if (out != stdout)
+    {
+        (void)fclose(out);
+    }
+    Cleanup(&ctx);
+    return status;
+}
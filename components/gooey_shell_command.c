@@ -0,0 +1,198 @@
+#include "gooey_shell.h"
+#include "gooey_shell_command.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+static void HandleCommandEventFd(GooeyShellState *state, int fd, unsigned int events, void *data)
+{
+    uint64_t count = 0;
+    (void)events;
+    (void)data;
+    while (read(fd, &count, sizeof(count)) > 0)
+    {
+    }
+    DrainShellCommands(state);
+}
+int InitializeCommandQueue(GooeyShellState *state)
+{
+    size_t i = 0;
+    if (state == NULL)
+    {
+        return 0;
+    }
+    for (i = 0; i < SHELL_COMMAND_QUEUE_SIZE; i++)
+    {
+        atomic_init(&state->command_slots[i].sequence, i);
+        state->command_slots[i].command.argument = NULL;
+    }
+    atomic_init(&state->command_head, 0);
+    atomic_init(&state->command_tail, 0);
+    state->command_event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (state->command_event_fd < 0)
+    {
+        LogError("InitializeCommandQueue: eventfd failed: %s", strerror(errno));
+        return 0;
+    }
+    if (WatchFd(state, state->command_event_fd, EPOLLIN, HandleCommandEventFd, NULL) != 0)
+    {
+        (void)close(state->command_event_fd);
+        state->command_event_fd = -1;
+        return 0;
+    }
+    return 1;
+}
+int EnqueueShellCommand(GooeyShellState *state, ShellCommandType type, Window window, const char *argument)
+{
+    ShellCommandSlot *slot = NULL;
+    char *copy = NULL;
+    size_t position = 0;
+    uint64_t one = 1;
+    if ((state == NULL) || (state->command_event_fd < 0))
+    {
+        return -1;
+    }
+    if (argument != NULL)
+    {
+        copy = strdup(argument);
+        if (copy == NULL)
+        {
+            LogError("EnqueueShellCommand: Failed to copy command argument");
+            return -1;
+        }
+    }
+    position = atomic_load_explicit(&state->command_tail, memory_order_relaxed);
+    for (;;)
+    {
+        size_t sequence = 0;
+        intptr_t diff = 0;
+        slot = &state->command_slots[position & (SHELL_COMMAND_QUEUE_SIZE - 1)];
+        sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        diff = (intptr_t)sequence - (intptr_t)position;
+        if (diff == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit(&state->command_tail, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed) != 0)
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            atomic_fetch_add_explicit(&state->command_queue_overflows, 1, memory_order_relaxed);
+            free(copy);
+            return -1;
+        }
+        else
+        {
+            position = atomic_load_explicit(&state->command_tail, memory_order_relaxed);
+        }
+    }
+    slot->command.type = type;
+    slot->command.window = window;
+    slot->command.argument = copy;
+    atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+    (void)write(state->command_event_fd, &one, sizeof(one));
+    return 0;
+}
+static int DequeueShellCommand(GooeyShellState *state, ShellCommand *command)
+{
+    size_t position = atomic_load_explicit(&state->command_head, memory_order_relaxed);
+    ShellCommandSlot *slot = &state->command_slots[position & (SHELL_COMMAND_QUEUE_SIZE - 1)];
+    size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+    if (sequence != position + 1)
+    {
+        return 0;
+    }
+    *command = slot->command;
+    slot->command.argument = NULL;
+    atomic_store_explicit(&state->command_head, position + 1, memory_order_relaxed);
+    atomic_store_explicit(&slot->sequence, position + SHELL_COMMAND_QUEUE_SIZE, memory_order_release);
+    return 1;
+}
+static void ExecuteShellCommand(GooeyShellState *state, const ShellCommand *command)
+{
+    WindowNode *node = NULL;
+    switch (command->type)
+    {
+    case SHELL_COMMAND_FOCUS_NEXT:
+        GooeyShell_FocusNextWindow(state);
+        return;
+    case SHELL_COMMAND_FOCUS_PREVIOUS:
+        GooeyShell_FocusPreviousWindow(state);
+        return;
+    case SHELL_COMMAND_RESET_STATS:
+        ResetShellStats(state);
+        return;
+    case SHELL_COMMAND_DUMP_TRACE:
+        (void)DumpTraceRing(state, command->argument);
+        return;
+    case SHELL_COMMAND_SET_WALLPAPER:
+        if (command->argument != NULL)
+        {
+            SendWallpaperChangeThroughDBus(state, command->argument);
+            WriteConfigKey(state->config_file, "wallpaper_path", command->argument);
+        }
+        return;
+    default:
+        break;
+    }
+    node = FindWindowNodeByFrame(state, command->window);
+    if (node == NULL)
+    {
+        return;
+    }
+    switch (command->type)
+    {
+    case SHELL_COMMAND_MINIMIZE:
+        MinimizeWindow(state, node);
+        break;
+    case SHELL_COMMAND_RESTORE:
+        RestoreWindow(state, node);
+        break;
+    case SHELL_COMMAND_CLOSE:
+        CloseWindow(state, node);
+        break;
+    case SHELL_COMMAND_TOGGLE_TILING:
+        GooeyShell_ToggleFloating(state, node->client);
+        break;
+    default:
+        break;
+    }
+}
+void DrainShellCommands(GooeyShellState *state)
+{
+    ShellCommand command;
+    if (state == NULL)
+    {
+        return;
+    }
+    while (DequeueShellCommand(state, &command) != 0)
+    {
+        unsigned long long start_ns = GetMonotonicTimeNs();
+        unsigned long start_request = NextRequest(state->display);
+        ExecuteShellCommand(state, &command);
+        RecordCommandStats(state, command.type, GetMonotonicTimeNs() - start_ns,
+                           NextRequest(state->display) - start_request);
+        free(command.argument);
+    }
+}
+void CleanupCommandQueue(GooeyShellState *state)
+{
+    ShellCommand command;
+    if ((state == NULL) || (state->command_event_fd < 0))
+    {
+        return;
+    }
+    while (DequeueShellCommand(state, &command) != 0)
+    {
+        free(command.argument);
+    }
+    UnwatchFd(state, state->command_event_fd);
+    (void)close(state->command_event_fd);
+    state->command_event_fd = -1;
+}
@@ -0,0 +1,8 @@
+#ifndef GOOEY_SHELL_COMMAND_H
+#define GOOEY_SHELL_COMMAND_H
+#include "gooey_shell.h"
+int InitializeCommandQueue(GooeyShellState *state);
+void CleanupCommandQueue(GooeyShellState *state);
+int EnqueueShellCommand(GooeyShellState *state, ShellCommandType type, Window window, const char *argument);
+void DrainShellCommands(GooeyShellState *state);
+#endif
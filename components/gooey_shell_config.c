@@ -301,6 +301,9 @@ void InitializeDefaultKeybinds(KeybindConfig *keybinds)
     keybinds->focus_previous_window = strdup("Alt+k");
     keybinds->set_tiling_layout = strdup("Alt+t");
     keybinds->set_monocle_layout = strdup("Alt+m");
+    keybinds->set_master_stack_layout = strdup("Alt+s");
+    keybinds->set_grid_layout = strdup("Alt+g");
+    keybinds->set_columns_layout = strdup("Alt+c");
     keybinds->shrink_width = strdup("Alt+h");
     keybinds->grow_width = strdup("Alt+l");
     keybinds->shrink_height = strdup("Alt+y");
@@ -347,6 +350,9 @@ void FreeKeybinds(KeybindConfig *keybinds)
     SAFE_FREE(keybinds->focus_previous_window);
     SAFE_FREE(keybinds->set_tiling_layout);
     SAFE_FREE(keybinds->set_monocle_layout);
+    SAFE_FREE(keybinds->set_master_stack_layout);
+    SAFE_FREE(keybinds->set_grid_layout);
+    SAFE_FREE(keybinds->set_columns_layout);
     SAFE_FREE(keybinds->shrink_width);
     SAFE_FREE(keybinds->grow_width);
     SAFE_FREE(keybinds->shrink_height);
@@ -361,33 +367,45 @@ void FreeKeybinds(KeybindConfig *keybinds)
         SAFE_FREE(keybinds->switch_workspace[i]);
     }
 }
+static void AddCompiledKeybind(GooeyShellState *state, KeyCode keycode, unsigned int mod_mask,
+                               KeyAction action, int arg)
+{
+    unsigned int clean_mod_mask = mod_mask & (unsigned int)(~(LockMask | Mod2Mask));
+    int index = 0;
+    if (state->compiled_keybind_count >= MAX_COMPILED_KEYBINDS)
+    {
+        LogError("AddCompiledKeybind: Keybind table full");
+        return;
+    }
+    index = state->keybind_heads[keycode];
+    while (index != 0)
+    {
+        if (state->compiled_keybinds[index - 1].mod_mask == clean_mod_mask)
+        {
+            return;
+        }
+        index = state->compiled_keybinds[index - 1].next;
+    }
+    index = state->compiled_keybind_count;
+    state->compiled_keybinds[index].mod_mask = clean_mod_mask;
+    state->compiled_keybinds[index].action = action;
+    state->compiled_keybinds[index].arg = arg;
+    state->compiled_keybinds[index].next = state->keybind_heads[keycode];
+    state->keybind_heads[keycode] = index + 1;
+    state->compiled_keybind_count++;
+}
 void GrabKeys(GooeyShellState *state)
 {
     typedef struct
     {
         const char *keybind_str;
         const char *name;
+        KeyAction action;
+        int arg;
     } KeybindMapping;
-    const KeybindMapping keybinds[] = {
-        {NULL, "launch_terminal"},
-        {NULL, "close_window"},
-        {NULL, "toggle_floating"},
-        {NULL, "focus_next_window"},
-        {NULL, "focus_previous_window"},
-        {NULL, "set_tiling_layout"},
-        {NULL, "set_monocle_layout"},
-        {NULL, "shrink_width"},
-        {NULL, "grow_width"},
-        {NULL, "shrink_height"},
-        {NULL, "grow_height"},
-        {NULL, "toggle_layout"},
-        {NULL, "move_window_prev_monitor"},
-        {NULL, "move_window_next_monitor"},
-        {NULL, "launch_menu"},
-        {NULL, "logout"},
-    };
-    const int NUM_KEYBINDS = (int)(sizeof(keybinds) / sizeof(keybinds[0]));
     const int MAX_WORKSPACES = 9;
+    KeybindMapping keybinds[MAX_COMPILED_KEYBINDS];
+    int num_keybinds = 0;
     int i;
     if (state == NULL)
     {
@@ -399,52 +417,50 @@ void GrabKeys(GooeyShellState *state)
         LogError("GrabKeys: Invalid window state");
         return;
     }
-    KeybindMapping actual_keybinds[NUM_KEYBINDS];
-    (void)memcpy(actual_keybinds, keybinds, sizeof(keybinds));
-    actual_keybinds[0].keybind_str = state->keybinds.launch_terminal;
-    actual_keybinds[1].keybind_str = state->keybinds.close_window;
-    actual_keybinds[2].keybind_str = state->keybinds.toggle_floating;
-    actual_keybinds[3].keybind_str = state->keybinds.focus_next_window;
-    actual_keybinds[4].keybind_str = state->keybinds.focus_previous_window;
-    actual_keybinds[5].keybind_str = state->keybinds.set_tiling_layout;
-    actual_keybinds[6].keybind_str = state->keybinds.set_monocle_layout;
-    actual_keybinds[7].keybind_str = state->keybinds.shrink_width;
-    actual_keybinds[8].keybind_str = state->keybinds.grow_width;
-    actual_keybinds[9].keybind_str = state->keybinds.shrink_height;
-    actual_keybinds[10].keybind_str = state->keybinds.grow_height;
-    actual_keybinds[11].keybind_str = state->keybinds.toggle_layout;
-    actual_keybinds[12].keybind_str = state->keybinds.move_window_prev_monitor;
-    actual_keybinds[13].keybind_str = state->keybinds.move_window_next_monitor;
-    actual_keybinds[14].keybind_str = state->keybinds.launch_menu;
-    actual_keybinds[15].keybind_str = state->keybinds.logout;
-    XUngrabKey(state->display, AnyKey, AnyModifier, state->root);
+    const KeybindMapping actions[] = {
+        {state->keybinds.launch_terminal, "launch_terminal", KEY_ACTION_LAUNCH_TERMINAL, 0},
+        {state->keybinds.close_window, "close_window", KEY_ACTION_CLOSE_WINDOW, 0},
+        {state->keybinds.toggle_floating, "toggle_floating", KEY_ACTION_TOGGLE_FLOATING, 0},
+        {state->keybinds.focus_next_window, "focus_next_window", KEY_ACTION_FOCUS_NEXT_WINDOW, 0},
+        {state->keybinds.focus_previous_window, "focus_previous_window", KEY_ACTION_FOCUS_PREVIOUS_WINDOW, 0},
+        {state->keybinds.set_tiling_layout, "set_tiling_layout", KEY_ACTION_SET_TILING_LAYOUT, 0},
+        {state->keybinds.set_monocle_layout, "set_monocle_layout", KEY_ACTION_SET_MONOCLE_LAYOUT, 0},
+        {state->keybinds.set_master_stack_layout, "set_master_stack_layout", KEY_ACTION_SET_MASTER_STACK_LAYOUT, 0},
+        {state->keybinds.set_grid_layout, "set_grid_layout", KEY_ACTION_SET_GRID_LAYOUT, 0},
+        {state->keybinds.set_columns_layout, "set_columns_layout", KEY_ACTION_SET_COLUMNS_LAYOUT, 0},
+        {state->keybinds.shrink_width, "shrink_width", KEY_ACTION_SHRINK_WIDTH, 0},
+        {state->keybinds.grow_width, "grow_width", KEY_ACTION_GROW_WIDTH, 0},
+        {state->keybinds.shrink_height, "shrink_height", KEY_ACTION_SHRINK_HEIGHT, 0},
+        {state->keybinds.grow_height, "grow_height", KEY_ACTION_GROW_HEIGHT, 0},
+        {state->keybinds.toggle_layout, "toggle_layout", KEY_ACTION_TOGGLE_LAYOUT, 0},
+        {state->keybinds.move_window_prev_monitor, "move_window_prev_monitor", KEY_ACTION_MOVE_WINDOW_PREV_MONITOR, 0},
+        {state->keybinds.move_window_next_monitor, "move_window_next_monitor", KEY_ACTION_MOVE_WINDOW_NEXT_MONITOR, 0},
+        {state->keybinds.launch_menu, "launch_menu", KEY_ACTION_LAUNCH_MENU, 0},
+        {state->keybinds.logout, "logout", KEY_ACTION_LOGOUT, 0},
+    };
+    for (i = 0; i < (int)(sizeof(actions) / sizeof(actions[0])); i++)
+    {
+        keybinds[num_keybinds] = actions[i];
+        num_keybinds++;
+    }
     for (i = 0; i < MAX_WORKSPACES; i++)
     {
-        unsigned int mod_mask = 0U;
-        KeyCode keycode = 0U;
-        if (state->keybinds.switch_workspace[i] != NULL)
-        {
-            keycode = ParseKeybind(state, state->keybinds.switch_workspace[i], &mod_mask);
-            if (keycode != 0U)
-            {
-                (void)XGrabKey(state->display, keycode, mod_mask,
-                               state->root, True, GrabModeAsync, GrabModeAsync);
-                (void)XGrabKey(state->display, keycode, mod_mask | LockMask,
-                               state->root, True, GrabModeAsync, GrabModeAsync);
-                (void)XGrabKey(state->display, keycode, mod_mask | Mod2Mask,
-                               state->root, True, GrabModeAsync, GrabModeAsync);
-                (void)XGrabKey(state->display, keycode, mod_mask | LockMask | Mod2Mask,
-                               state->root, True, GrabModeAsync, GrabModeAsync);
-            }
-        }
+        keybinds[num_keybinds].keybind_str = state->keybinds.switch_workspace[i];
+        keybinds[num_keybinds].name = "switch_workspace";
+        keybinds[num_keybinds].action = KEY_ACTION_SWITCH_WORKSPACE;
+        keybinds[num_keybinds].arg = i + 1;
+        num_keybinds++;
     }
-    for (i = 0; i < NUM_KEYBINDS; i++)
+    (void)memset(state->keybind_heads, 0, sizeof(state->keybind_heads));
+    state->compiled_keybind_count = 0;
+    XUngrabKey(state->display, AnyKey, AnyModifier, state->root);
+    for (i = 0; i < num_keybinds; i++)
     {
-        if (actual_keybinds[i].keybind_str != NULL)
+        if (keybinds[i].keybind_str != NULL)
         {
             unsigned int mod_mask = 0U;
             KeyCode keycode = 0U;
-            keycode = ParseKeybind(state, actual_keybinds[i].keybind_str, &mod_mask);
+            keycode = ParseKeybind(state, keybinds[i].keybind_str, &mod_mask);
             if (keycode != 0U)
             {
                 (void)XGrabKey(state->display, keycode, mod_mask,
@@ -455,16 +471,42 @@ void GrabKeys(GooeyShellState *state)
                                state->root, True, GrabModeAsync, GrabModeAsync);
                 (void)XGrabKey(state->display, keycode, mod_mask | LockMask | Mod2Mask,
                                state->root, True, GrabModeAsync, GrabModeAsync);
+                AddCompiledKeybind(state, keycode, mod_mask, keybinds[i].action, keybinds[i].arg);
             }
             else
             {
                 LogError("GrabKeys: Failed to parse keybind: %s = %s",
-                         actual_keybinds[i].name, actual_keybinds[i].keybind_str);
+                         keybinds[i].name, keybinds[i].keybind_str);
             }
         }
     }
     (void)XFlush(state->display);
 }
+KeyAction LookupKeybind(GooeyShellState *state, XKeyEvent *ev, int *arg)
+{
+    unsigned int actual_mod_mask = 0U;
+    int index = 0;
+    if ((state == NULL) || (ev == NULL) || (ev->keycode > 255U))
+    {
+        return KEY_ACTION_NONE;
+    }
+    actual_mod_mask = ev->state & (unsigned int)(~(LockMask | Mod2Mask));
+    index = state->keybind_heads[ev->keycode];
+    while (index != 0)
+    {
+        CompiledKeybind *entry = &state->compiled_keybinds[index - 1];
+        if (entry->mod_mask == actual_mod_mask)
+        {
+            if (arg != NULL)
+            {
+                *arg = entry->arg;
+            }
+            return entry->action;
+        }
+        index = entry->next;
+    }
+    return KEY_ACTION_NONE;
+}
 char *ExpandPath(const char *path)
 {
     const char *home = NULL;
@@ -589,6 +631,8 @@ void CreateDefaultConfig(const char *config_path)
     (void)fprintf(file, "window_opacity = 0.95\n\n");
     (void)fprintf(file, "# Enable mouse focus (true/false)\n");
     (void)fprintf(file, "mouse_focus = true\n\n");
+    (void)fprintf(file, "# Drag/resize commit rate in Hz (0 follows the monitor refresh rate)\n");
+    (void)fprintf(file, "motion_commit_rate = 0\n\n");
     (void)fprintf(file, "# Keybinds (Format: Mod+Key, Mod can be: Alt, Ctrl, Shift, Super)\n");
     (void)fprintf(file, "# Launch App Menu\n");
     (void)fprintf(file, "# keybind.launch_menu = Super+m\n");
@@ -601,6 +645,9 @@ void CreateDefaultConfig(const char *config_path)
     (void)fprintf(file, "# Layout management\n");
     (void)fprintf(file, "keybind.set_tiling_layout = Alt+t\n");
     (void)fprintf(file, "keybind.set_monocle_layout = Alt+m\n");
+    (void)fprintf(file, "keybind.set_master_stack_layout = Alt+s\n");
+    (void)fprintf(file, "keybind.set_grid_layout = Alt+g\n");
+    (void)fprintf(file, "keybind.set_columns_layout = Alt+c\n");
     (void)fprintf(file, "keybind.toggle_layout = Alt+space\n\n");
     (void)fprintf(file, "# Window resizing\n");
     (void)fprintf(file, "keybind.shrink_width = Alt+h\n");
@@ -628,29 +675,6 @@ void CreateDefaultConfig(const char *config_path)
         LogInfo("CreateDefaultConfig: Created default config file: %s", config_path);
     }
 }
-int KeybindMatches(GooeyShellState *state, XKeyEvent *ev, const char *keybind_str)
-{
-    unsigned int expected_mod_mask = 0U;
-    unsigned int actual_mod_mask = 0U;
-    unsigned int clean_expected_mod_mask = 0U;
-    KeyCode expected_keycode = 0U;
-    if ((state == NULL) || (ev == NULL) || (keybind_str == NULL))
-    {
-        return 0;
-    }
-    expected_keycode = ParseKeybind(state, keybind_str, &expected_mod_mask);
-    if (expected_keycode == 0U)
-    {
-        return 0;
-    }
-    if (ev->keycode != expected_keycode)
-    {
-        return 0;
-    }
-    actual_mod_mask = ev->state & (unsigned int)(~(LockMask | Mod2Mask));
-    clean_expected_mod_mask = expected_mod_mask & (unsigned int)(~(LockMask | Mod2Mask));
-    return (actual_mod_mask == clean_expected_mod_mask) ? 1 : 0;
-}
 int GooeyShell_LoadConfig(GooeyShellState *state, const char *config_path)
 {
     char *expanded_path = NULL;
@@ -744,9 +768,18 @@ int GooeyShell_LoadConfig(GooeyShellState *state, const char *config_path)
                 else if (strcmp(key, "focused_border_color") == 0)
                 {
                     state->focused_border_color = ParseColor(value_start);
-                    LogInfo("Config: focused_border_color = %s (0x%06X)",
+                    LogInfo("Config: focused_border_color = %s (0x%06lX)",
                             value_start, state->focused_border_color);
                 }
+                else if (strcmp(key, "motion_commit_rate") == 0)
+                {
+                    state->motion_commit_rate = atoi(value_start);
+                    if (state->motion_commit_rate < 0)
+                    {
+                        state->motion_commit_rate = 0;
+                    }
+                    LogInfo("Config: motion_commit_rate = %d", state->motion_commit_rate);
+                }
                 else if (strcmp(key, "logout_command") == 0)
                 {
                     SAFE_FREE(state->logout_command);
@@ -794,6 +827,21 @@ int GooeyShell_LoadConfig(GooeyShellState *state, const char *config_path)
                         SAFE_FREE(state->keybinds.set_monocle_layout);
                         state->keybinds.set_monocle_layout = strdup(value_start);
                     }
+                    else if (strcmp(keybind_name, "set_master_stack_layout") == 0)
+                    {
+                        SAFE_FREE(state->keybinds.set_master_stack_layout);
+                        state->keybinds.set_master_stack_layout = strdup(value_start);
+                    }
+                    else if (strcmp(keybind_name, "set_grid_layout") == 0)
+                    {
+                        SAFE_FREE(state->keybinds.set_grid_layout);
+                        state->keybinds.set_grid_layout = strdup(value_start);
+                    }
+                    else if (strcmp(keybind_name, "set_columns_layout") == 0)
+                    {
+                        SAFE_FREE(state->keybinds.set_columns_layout);
+                        state->keybinds.set_columns_layout = strdup(value_start);
+                    }
                     else if (strcmp(keybind_name, "shrink_width") == 0)
                     {
                         SAFE_FREE(state->keybinds.shrink_width);
@@ -857,6 +905,20 @@ int GooeyShell_LoadConfig(GooeyShellState *state, const char *config_path)
     result = 1;
     return result;
 }
+void GooeyShell_ReloadConfig(GooeyShellState *state)
+{
+    if (ValidateWindowState(state) == 0)
+    {
+        return;
+    }
+    LogInfo("GooeyShell_ReloadConfig: Reloading %s", state->config_file);
+    FreeKeybinds(&state->keybinds);
+    InitializeDefaultKeybinds(&state->keybinds);
+    SAFE_FREE(state->wallpaper_path);
+    state->motion_commit_rate = 0;
+    (void)GooeyShell_LoadConfig(state, state->config_file);
+    GrabKeys(state);
+}
 void GooeyShell_Logout(GooeyShellState *state)
 {
     if (state == NULL)
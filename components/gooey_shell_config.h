@@ -6,7 +6,8 @@ void RegrabKeys(GooeyShellState *state);
 KeyCode ParseKeybind(GooeyShellState *state, const char *keybind_str, unsigned int *mod_mask);
 void InitializeDefaultKeybinds(KeybindConfig *keybinds);
 void FreeKeybinds(KeybindConfig *keybinds);
-int KeybindMatches(GooeyShellState *state, XKeyEvent *ev, const char *keybind_str);
+KeyAction LookupKeybind(GooeyShellState *state, XKeyEvent *ev, int *arg);
+void GooeyShell_ReloadConfig(GooeyShellState *state);
 void HandleMouseFocus(GooeyShellState *state, XMotionEvent *ev);
 char *ExpandPath(const char *path);
 int ParseColor(const char *color_str);
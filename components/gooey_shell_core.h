@@ -5,6 +5,7 @@
 #include <X11/Xatom.h>
 #include <dbus/dbus.h>
 #include <GLPS/glps_thread.h>
+#define MAX_DBUS_WATCHES 8
 #define SAFE_FREE(ptr)  \
     do                  \
     {                   \
@@ -39,27 +40,33 @@
         }                             \
     } while (0)
 extern PrecomputedAtoms atoms;
-extern Window *opened_windows;
-extern int opened_windows_count;
-extern int opened_windows_capacity;
+extern _Atomic(OpenedWindowSet *) opened_windows;
+extern atomic_int opened_windows_readers;
 extern volatile int dbus_thread_running;
 extern gthread_t dbus_thread;
 extern gthread_mutex_t dbus_mutex;
 extern gthread_mutex_t window_list_mutex;
 extern int window_list_update_pending;
 extern int pending_x_flush;
+extern int dbus_wake_fd;
 int IgnoreXError(Display *d, XErrorEvent *e);
 void InitializeAtoms(Display *display);
+Monitor *QueryMonitors(GooeyShellState *state, int use_current, int *count);
 int InitializeMultiMonitor(GooeyShellState *state);
 void FreeMultiMonitor(GooeyShellState *state);
 int GetMonitorForWindow(GooeyShellState *state, int x, int y, int width, int height);
-int CreateFrameWindow(GooeyShellState *state, Window client, int is_desktop_app);
-int CreateFullscreenAppWindow(GooeyShellState *state, Window client, int stay_on_top);
+int CreateFrameWindow(GooeyShellState *state, Window client, int is_desktop_app, const WindowProbe *probe);
+int CreateFullscreenAppWindow(GooeyShellState *state, Window client, int stay_on_top, const WindowProbe *probe);
 void DrawTitleBar(GooeyShellState *state, WindowNode *node);
+void FreeTitleBarCache(GooeyShellState *state, WindowNode *node);
 void HandleButtonPress(GooeyShellState *state, XButtonEvent *ev);
 void HandleButtonRelease(GooeyShellState *state, XButtonEvent *ev);
 void HandleMotionNotify(GooeyShellState *state, XMotionEvent *ev);
 void HandleMouseFocus(GooeyShellState *state, XMotionEvent *ev);
+int WindowIndexInsert(GooeyShellState *state, Window key, WindowNode *node);
+void WindowIndexRemove(GooeyShellState *state, Window key);
+WindowNode *WindowIndexLookup(GooeyShellState *state, Window key);
+void FreeWindowIndex(GooeyShellState *state);
 WindowNode *FindWindowNodeByFrame(GooeyShellState *state, Window frame);
 WindowNode *FindWindowNodeByClient(GooeyShellState *state, Window client);
 void CloseWindow(GooeyShellState *state, WindowNode *node);
@@ -72,42 +79,41 @@ void UpdateWindowGeometry(GooeyShellState *state, WindowNode *node);
 void UpdateCursorForWindow(GooeyShellState *state, WindowNode *node, int x, int y);
 void SetupDesktopApp(GooeyShellState *state, WindowNode *node);
 void SetupFullscreenApp(GooeyShellState *state, WindowNode *node, int stay_on_top);
-void EnsureDesktopAppStaysInBackground(GooeyShellState *state);
-void EnsureFullscreenAppStaysOnTop(GooeyShellState *state);
 Cursor CreateCustomCursor(GooeyShellState *state);
 void RemoveWindow(GooeyShellState *state, Window client);
 void FreeWindowNode(WindowNode *node);
-void ReapZombieProcesses(void);
-int IsDesktopAppByProperties(GooeyShellState *state, Window client);
-int IsFullscreenAppByProperties(GooeyShellState *state, Window client, int *stay_on_top);
-int DetectAppTypeByTitleClass(GooeyShellState *state, Window client, int *is_desktop, int *is_fullscreen, int *stay_on_top);
+int MatchTitleAppType(const char *title, int *is_desktop, int *is_fullscreen, int *stay_on_top);
+int MatchClassAppType(const char *res_name, int *is_desktop, int *is_fullscreen, int *stay_on_top);
 void SetWindowStateProperties(GooeyShellState *state, Window window, Atom *states, int count);
 char *StrDup(const char *str);
 void SafeXFree(void *data);
 int ValidateWindowState(GooeyShellState *state);
-void LogError(const char *message, ...);
-void LogInfo(const char *message, ...);
 void AddToOpenedWindows(Window window);
 void RemoveFromOpenedWindows(Window window);
 int IsWindowInOpenedWindows(Window window);
-void SendWindowStateThroughDBus(GooeyShellState *state, Window window, const char *st);
-void SendWorkspaceChangedThroughDBus(GooeyShellState *state, int old_workspace, int new_workspace);
+const OpenedWindowSet *AcquireOpenedWindows(void);
+void ReleaseOpenedWindows(void);
+void FreeOpenedWindows(void);
 void SendWallpaperChangeThroughDBus(GooeyShellState *state, const char *wallpaper_path);
 void HandleDBusWindowCommand(GooeyShellState *state, DBusMessage *msg);
 void ScheduleWindowListUpdate(GooeyShellState *state);
 void OptimizedXFlush(GooeyShellState *state);
 void FocusRootWindow(GooeyShellState *state);
+void RepaintFocusDecorations(GooeyShellState *state, WindowNode *node);
 void ProcessDBusMessage(GooeyShellState *state, DBusMessage *msg);
+void WakeDBusThread(void);
 void *DBusListenerThread(void *arg);
 void SetupDBUS(GooeyShellState *state);
 void GooeyShell_MarkAsDesktopApp(GooeyShellState *state, Window client);
+void HandleXEvent(GooeyShellState *state, XEvent *ev);
+int ProcessPendingXEvents(GooeyShellState *state);
 void GooeyShell_RunEventLoop(GooeyShellState *state);
 void GooeyShell_AddFullscreenApp(GooeyShellState *state, const char *command, int stay_on_top);
 void GooeyShell_AddWindow(GooeyShellState *state, const char *command, int desktop_app);
 void GooeyShell_ToggleTitlebar(GooeyShellState *state, Window client);
 void GooeyShell_SetTitlebarEnabled(GooeyShellState *state, Window client, int enabled);
 int GooeyShell_IsTitlebarEnabled(GooeyShellState *state, Window client);
-Window *GooeyShell_GetOpenedWindows(GooeyShellState *state, int *count);
+int GooeyShell_GetOpenedWindows(Window *windows, int max_count);
 int GooeyShell_IsWindowOpened(GooeyShellState *state, Window window);
 int GooeyShell_IsWindowMinimized(GooeyShellState *state, Window client);
 void GooeyShell_Cleanup(GooeyShellState *state);
@@ -0,0 +1,205 @@
+#include "gooey_shell.h"
+#include "gooey_shell_geometry.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+void QueueWindowGeometry(GooeyShellState *state, WindowNode *node)
+{
+    if ((state == NULL) || (node == NULL) || (node->geometry_queued != 0))
+    {
+        return;
+    }
+    node->geometry_queued = 1;
+    node->next_queued = state->geometry_queue;
+    state->geometry_queue = node;
+}
+void DiscardWindowGeometry(GooeyShellState *state, WindowNode *node)
+{
+    WindowNode **current = NULL;
+    if ((state == NULL) || (node == NULL) || (node->geometry_queued == 0))
+    {
+        return;
+    }
+    current = &state->geometry_queue;
+    while (*current != NULL)
+    {
+        if (*current == node)
+        {
+            *current = node->next_queued;
+            break;
+        }
+        current = &(*current)->next_queued;
+    }
+    node->geometry_queued = 0;
+    node->next_queued = NULL;
+}
+void InvalidateWindowGeometry(WindowNode *node)
+{
+    if (node != NULL)
+    {
+        node->committed_geometry.valid = 0;
+    }
+}
+void SetWindowBorderColor(GooeyShellState *state, WindowNode *node, unsigned long color)
+{
+    if ((state == NULL) || (node == NULL) || (node->frame == None))
+    {
+        return;
+    }
+    if ((node->committed_geometry.border_valid != 0) && (node->committed_geometry.border_color == color))
+    {
+        return;
+    }
+    XSetWindowBorder(state->display, node->frame, color);
+    node->committed_geometry.border_color = color;
+    node->committed_geometry.border_valid = 1;
+    state->geometry_requests_sent++;
+}
+static int ComputeWindowGeometry(GooeyShellState *state, WindowNode *node, WindowGeometryState *out)
+{
+    Monitor *mon = NULL;
+    *out = node->committed_geometry;
+    if ((node->is_desktop_app != 0) || (node->is_fullscreen_app != 0))
+    {
+        if (node->monitor_number < state->monitor_info.num_monitors)
+        {
+            mon = &state->monitor_info.monitors[node->monitor_number];
+            out->frame_x = mon->x;
+            out->frame_y = mon->y;
+            out->frame_width = mon->width;
+            out->frame_height = mon->height;
+            out->client_x = 0;
+            out->client_y = 0;
+            out->client_width = mon->width;
+            out->client_height = mon->height;
+            return 1;
+        }
+        return 0;
+    }
+    out->frame_x = node->x;
+    out->frame_y = node->y;
+    out->frame_width = node->width + 2 * BORDER_WIDTH;
+    out->frame_height = node->height + ((node->is_titlebar_disabled != 0) ? 0 : TITLE_BAR_HEIGHT) + 2 * BORDER_WIDTH;
+    out->client_x = BORDER_WIDTH;
+    out->client_y = (node->is_titlebar_disabled != 0) ? BORDER_WIDTH : TITLE_BAR_HEIGHT + BORDER_WIDTH;
+    out->client_width = node->width;
+    out->client_height = node->height;
+    return 1;
+}
+static unsigned int ConfigureIfChanged(GooeyShellState *state, Window window, int valid,
+                                       int old_x, int old_y, int old_width, int old_height,
+                                       int x, int y, int width, int height)
+{
+    XWindowChanges changes;
+    unsigned int mask = 0U;
+    if ((valid == 0) || (old_x != x))
+    {
+        mask |= CWX;
+    }
+    if ((valid == 0) || (old_y != y))
+    {
+        mask |= CWY;
+    }
+    if ((valid == 0) || (old_width != width))
+    {
+        mask |= CWWidth;
+    }
+    if ((valid == 0) || (old_height != height))
+    {
+        mask |= CWHeight;
+    }
+    if (mask == 0U)
+    {
+        return 0U;
+    }
+    memset(&changes, 0, sizeof(changes));
+    changes.x = x;
+    changes.y = y;
+    changes.width = (width > 0) ? width : 1;
+    changes.height = (height > 0) ? height : 1;
+    XConfigureWindow(state->display, window, mask, &changes);
+    state->geometry_requests_sent++;
+    return mask;
+}
+static void CommitNodeGeometry(GooeyShellState *state, WindowNode *node)
+{
+    WindowGeometryState desired;
+    WindowGeometryState *committed = &node->committed_geometry;
+    unsigned int frame_mask = 0U;
+    unsigned int client_mask = 0U;
+    if ((node->frame == None) || (node->client == None))
+    {
+        return;
+    }
+    SetWindowBorderColor(state, node, (node->frame == state->focused_window) ? state->focused_border_color : state->border_color);
+    if (ComputeWindowGeometry(state, node, &desired) == 0)
+    {
+        return;
+    }
+    frame_mask = ConfigureIfChanged(state, node->frame, committed->valid,
+                                    committed->frame_x, committed->frame_y,
+                                    committed->frame_width, committed->frame_height,
+                                    desired.frame_x, desired.frame_y,
+                                    desired.frame_width, desired.frame_height);
+    client_mask = ConfigureIfChanged(state, node->client, committed->valid,
+                                     committed->client_x, committed->client_y,
+                                     committed->client_width, committed->client_height,
+                                     desired.client_x, desired.client_y,
+                                     desired.client_width, desired.client_height);
+    desired.border_color = committed->border_color;
+    desired.border_valid = committed->border_valid;
+    desired.valid = 1;
+    *committed = desired;
+    if (((frame_mask & (CWX | CWY)) != 0U) && ((client_mask & (CWWidth | CWHeight)) == 0U))
+    {
+        SendSyntheticConfigureNotify(state, node);
+    }
+    if ((node->is_desktop_app == 0) && (node->is_fullscreen_app == 0) &&
+        (node->is_titlebar_disabled == 0) && ((frame_mask & (CWWidth | CWHeight)) != 0U))
+    {
+        DrawTitleBar(state, node);
+    }
+}
+int CommitWindowGeometry(GooeyShellState *state)
+{
+    WindowNode *node = NULL;
+    int committed = 0;
+    if (ValidateWindowState(state) == 0)
+    {
+        return 0;
+    }
+    while (state->geometry_queue != NULL)
+    {
+        node = state->geometry_queue;
+        state->geometry_queue = node->next_queued;
+        node->geometry_queued = 0;
+        node->next_queued = NULL;
+        CommitNodeGeometry(state, node);
+        committed++;
+    }
+    return committed;
+}
+void SendSyntheticConfigureNotify(GooeyShellState *state, WindowNode *node)
+{
+    XConfigureEvent ce;
+    WindowGeometryState *committed = NULL;
+    if ((state == NULL) || (node == NULL) || (node->committed_geometry.valid == 0))
+    {
+        return;
+    }
+    committed = &node->committed_geometry;
+    memset(&ce, 0, sizeof(ce));
+    ce.type = ConfigureNotify;
+    ce.display = state->display;
+    ce.event = node->client;
+    ce.window = node->client;
+    ce.x = committed->frame_x + committed->client_x;
+    ce.y = committed->frame_y + committed->client_y;
+    ce.width = committed->client_width;
+    ce.height = committed->client_height;
+    ce.border_width = 0;
+    ce.above = None;
+    ce.override_redirect = False;
+    XSendEvent(state->display, node->client, False, StructureNotifyMask, (XEvent *)&ce);
+    state->geometry_requests_sent++;
+}
@@ -0,0 +1,10 @@
+#ifndef GOOEY_SHELL_GEOMETRY_H
+#define GOOEY_SHELL_GEOMETRY_H
+#include "gooey_shell.h"
+void QueueWindowGeometry(GooeyShellState *state, WindowNode *node);
+void DiscardWindowGeometry(GooeyShellState *state, WindowNode *node);
+void InvalidateWindowGeometry(WindowNode *node);
+void SetWindowBorderColor(GooeyShellState *state, WindowNode *node, unsigned long color);
+int CommitWindowGeometry(GooeyShellState *state);
+void SendSyntheticConfigureNotify(GooeyShellState *state, WindowNode *node);
+#endif
@@ -0,0 +1,222 @@
+#include "gooey_shell_layout.h"
+#include <stddef.h>
+#include <math.h>
+static int ArrangeMonocle(const LayoutBox *area, const LayoutItem *items, int count,
+                          const LayoutParams *params, LayoutBox *out);
+static int ArrangeMasterStack(const LayoutBox *area, const LayoutItem *items, int count,
+                              const LayoutParams *params, LayoutBox *out);
+static int ArrangeGrid(const LayoutBox *area, const LayoutItem *items, int count,
+                       const LayoutParams *params, LayoutBox *out);
+static int ArrangeColumns(const LayoutBox *area, const LayoutItem *items, int count,
+                          const LayoutParams *params, LayoutBox *out);
+static const LayoutEngine layout_engines[LAYOUT_COUNT] = {
+    [LAYOUT_TILING] = {"tiling", NULL},
+    [LAYOUT_MONOCLE] = {"monocle", ArrangeMonocle},
+    [LAYOUT_FLOATING] = {"floating", NULL},
+    [LAYOUT_MASTER_STACK] = {"master_stack", ArrangeMasterStack},
+    [LAYOUT_GRID] = {"grid", ArrangeGrid},
+    [LAYOUT_COLUMNS] = {"columns", ArrangeColumns},
+};
+SplitDirection ChooseSplitDirection(int width, int height, int window_count)
+{
+    if (window_count <= 1)
+    {
+        return SPLIT_NONE;
+    }
+    if (width > (int)(height * 1.2f))
+    {
+        return SPLIT_VERTICAL;
+    }
+    else
+    {
+        return SPLIT_HORIZONTAL;
+    }
+}
+void SplitLayoutBox(const LayoutBox *box, SplitDirection split, float ratio, LayoutBox *first, LayoutBox *second)
+{
+    LayoutBox whole = *box;
+    *first = whole;
+    *second = whole;
+    if (split == SPLIT_VERTICAL)
+    {
+        first->width = (int)((float)whole.width * ratio);
+        second->x = whole.x + first->width;
+        second->width = whole.width - first->width;
+    }
+    else
+    {
+        first->height = (int)((float)whole.height * ratio);
+        second->y = whole.y + first->height;
+        second->height = whole.height - first->height;
+    }
+}
+static int ArrangeMonocle(const LayoutBox *area, const LayoutItem *items, int count,
+                          const LayoutParams *params, LayoutBox *out)
+{
+    int i = 0;
+    (void)items;
+    (void)params;
+    for (i = 0; i < count; i++)
+    {
+        out[i] = *area;
+    }
+    return count;
+}
+static int ArrangeMasterStack(const LayoutBox *area, const LayoutItem *items, int count,
+                              const LayoutParams *params, LayoutBox *out)
+{
+    LayoutBox stack;
+    float ratio = (params != NULL) ? params->master_ratio : 0.5f;
+    float total = 0.0f;
+    int use_ratios = 0;
+    int stack_count = count - 1;
+    int offset = 0;
+    int i = 0;
+    (void)items;
+    if (count <= 0)
+    {
+        return 0;
+    }
+    if (count == 1)
+    {
+        out[0] = *area;
+        return 1;
+    }
+    if ((ratio < 0.1f) || (ratio > 0.9f))
+    {
+        ratio = 0.5f;
+    }
+    SplitLayoutBox(area, SPLIT_VERTICAL, ratio, &out[0], &stack);
+    if ((params != NULL) && (params->stack_ratios != NULL) && (params->stack_ratios_count == stack_count))
+    {
+        for (i = 0; i < stack_count; i++)
+        {
+            total += params->stack_ratios[i];
+        }
+        use_ratios = (total > 0.0f) ? 1 : 0;
+    }
+    for (i = 0; i < stack_count; i++)
+    {
+        LayoutBox *box = &out[i + 1];
+        int height = 0;
+        if (i == stack_count - 1)
+        {
+            height = stack.height - offset;
+        }
+        else if (use_ratios != 0)
+        {
+            height = (int)((float)stack.height * params->stack_ratios[i] / total);
+        }
+        else
+        {
+            height = stack.height / stack_count;
+        }
+        box->x = stack.x;
+        box->y = stack.y + offset;
+        box->width = stack.width;
+        box->height = height;
+        offset += height;
+    }
+    return count;
+}
+static int ArrangeGrid(const LayoutBox *area, const LayoutItem *items, int count,
+                       const LayoutParams *params, LayoutBox *out)
+{
+    int columns = 0;
+    int rows = 0;
+    int index = 0;
+    int row = 0;
+    (void)items;
+    (void)params;
+    if (count <= 0)
+    {
+        return 0;
+    }
+    columns = (int)ceil(sqrt((double)count));
+    rows = (count + columns - 1) / columns;
+    for (row = 0; row < rows; row++)
+    {
+        int row_columns = ((row == rows - 1) && (count % columns != 0)) ? count % columns : columns;
+        int y = area->y + (area->height * row) / rows;
+        int height = area->y + (area->height * (row + 1)) / rows - y;
+        int column = 0;
+        for (column = 0; column < row_columns; column++)
+        {
+            int x = area->x + (area->width * column) / row_columns;
+            out[index].x = x;
+            out[index].y = y;
+            out[index].width = area->x + (area->width * (column + 1)) / row_columns - x;
+            out[index].height = height;
+            index++;
+        }
+    }
+    return count;
+}
+static int ArrangeColumns(const LayoutBox *area, const LayoutItem *items, int count,
+                          const LayoutParams *params, LayoutBox *out)
+{
+    int i = 0;
+    (void)items;
+    (void)params;
+    for (i = 0; i < count; i++)
+    {
+        int x = area->x + (area->width * i) / count;
+        out[i].x = x;
+        out[i].y = area->y;
+        out[i].width = area->x + (area->width * (i + 1)) / count - x;
+        out[i].height = area->height;
+    }
+    return count;
+}
+static void ApplySizeHints(const LayoutItem *item, LayoutBox *box)
+{
+    if ((item->max_width > 0) && (box->width > item->max_width))
+    {
+        box->width = item->max_width;
+    }
+    if ((item->max_height > 0) && (box->height > item->max_height))
+    {
+        box->height = item->max_height;
+    }
+    if (box->width < item->min_width)
+    {
+        box->width = item->min_width;
+    }
+    if (box->height < item->min_height)
+    {
+        box->height = item->min_height;
+    }
+}
+const LayoutEngine *GetLayoutEngine(LayoutMode mode)
+{
+    if ((mode < 0) || (mode >= LAYOUT_COUNT) || (layout_engines[mode].arrange == NULL))
+    {
+        return NULL;
+    }
+    return &layout_engines[mode];
+}
+const char *GetLayoutName(LayoutMode mode)
+{
+    if ((mode < 0) || (mode >= LAYOUT_COUNT))
+    {
+        return "unknown";
+    }
+    return layout_engines[mode].name;
+}
+int ComputeLayout(LayoutMode mode, const LayoutBox *area, const LayoutItem *items, int count,
+                  const LayoutParams *params, LayoutBox *out)
+{
+    const LayoutEngine *engine = GetLayoutEngine(mode);
+    int placed = 0;
+    int i = 0;
+    if ((engine == NULL) || (area == NULL) || (out == NULL) || (count < 0))
+    {
+        return -1;
+    }
+    placed = engine->arrange(area, items, count, params, out);
+    for (i = 0; (items != NULL) && (i < placed); i++)
+    {
+        ApplySizeHints(&items[i], &out[i]);
+    }
+    return placed;
+}
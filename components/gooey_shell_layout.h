@@ -0,0 +1,48 @@
+#ifndef GOOEY_SHELL_LAYOUT_H
+#define GOOEY_SHELL_LAYOUT_H
+typedef enum
+{
+    LAYOUT_TILING,
+    LAYOUT_MONOCLE,
+    LAYOUT_FLOATING,
+    LAYOUT_MASTER_STACK,
+    LAYOUT_GRID,
+    LAYOUT_COLUMNS,
+    LAYOUT_COUNT
+} LayoutMode;
+typedef enum
+{
+    SPLIT_NONE,
+    SPLIT_VERTICAL,
+    SPLIT_HORIZONTAL
+} SplitDirection;
+typedef struct LayoutBox
+{
+    int x, y;
+    int width, height;
+} LayoutBox;
+typedef struct LayoutItem
+{
+    int min_width, min_height;
+    int max_width, max_height;
+} LayoutItem;
+typedef struct LayoutParams
+{
+    float master_ratio;
+    const float *stack_ratios;
+    int stack_ratios_count;
+} LayoutParams;
+typedef int (*LayoutArrangeFunc)(const LayoutBox *area, const LayoutItem *items, int count,
+                                 const LayoutParams *params, LayoutBox *out);
+typedef struct LayoutEngine
+{
+    const char *name;
+    LayoutArrangeFunc arrange;
+} LayoutEngine;
+const LayoutEngine *GetLayoutEngine(LayoutMode mode);
+const char *GetLayoutName(LayoutMode mode);
+int ComputeLayout(LayoutMode mode, const LayoutBox *area, const LayoutItem *items, int count,
+                  const LayoutParams *params, LayoutBox *out);
+SplitDirection ChooseSplitDirection(int width, int height, int window_count);
+void SplitLayoutBox(const LayoutBox *box, SplitDirection split, float ratio, LayoutBox *first, LayoutBox *second);
+#endif
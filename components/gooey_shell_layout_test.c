@@ -0,0 +1,104 @@
+#include "gooey_shell_layout.h"
+#include <stdio.h>
+#include <string.h>
+static int failures = 0;
+static void ExpectBox(const char *name, const LayoutBox *box, int x, int y, int width, int height)
+{
+    if ((box->x != x) || (box->y != y) || (box->width != width) || (box->height != height))
+    {
+        fprintf(stderr, "%s: expected %d,%d %dx%d, got %d,%d %dx%d\n", name, x, y, width, height,
+                box->x, box->y, box->width, box->height);
+        failures++;
+    }
+}
+static void ExpectCount(const char *name, int placed, int expected)
+{
+    if (placed != expected)
+    {
+        fprintf(stderr, "%s: expected %d boxes, got %d\n", name, expected, placed);
+        failures++;
+    }
+}
+static void TestMasterStack(void)
+{
+    LayoutBox area = {0, 0, 1000, 600};
+    LayoutParams params = {0.6f, NULL, 0};
+    LayoutBox out[3];
+    int placed = ComputeLayout(LAYOUT_MASTER_STACK, &area, NULL, 3, &params, out);
+    ExpectCount("master_stack", placed, 3);
+    ExpectBox("master_stack master", &out[0], 0, 0, 600, 600);
+    ExpectBox("master_stack stack 0", &out[1], 600, 0, 400, 300);
+    ExpectBox("master_stack stack 1", &out[2], 600, 300, 400, 300);
+}
+static void TestMasterStackRatios(void)
+{
+    LayoutBox area = {0, 0, 1000, 600};
+    float ratios[2] = {1.0f, 2.0f};
+    LayoutParams params = {0.5f, ratios, 2};
+    LayoutBox out[3];
+    int placed = ComputeLayout(LAYOUT_MASTER_STACK, &area, NULL, 3, &params, out);
+    ExpectCount("master_stack_ratios", placed, 3);
+    ExpectBox("master_stack_ratios master", &out[0], 0, 0, 500, 600);
+    ExpectBox("master_stack_ratios stack 0", &out[1], 500, 0, 500, 200);
+    ExpectBox("master_stack_ratios stack 1", &out[2], 500, 200, 500, 400);
+}
+static void TestGrid(void)
+{
+    LayoutBox area = {10, 20, 900, 600};
+    LayoutBox out[5];
+    int placed = ComputeLayout(LAYOUT_GRID, &area, NULL, 5, NULL, out);
+    ExpectCount("grid", placed, 5);
+    ExpectBox("grid 0", &out[0], 10, 20, 300, 300);
+    ExpectBox("grid 1", &out[1], 310, 20, 300, 300);
+    ExpectBox("grid 2", &out[2], 610, 20, 300, 300);
+    ExpectBox("grid 3", &out[3], 10, 320, 450, 300);
+    ExpectBox("grid 4", &out[4], 460, 320, 450, 300);
+}
+static void TestColumns(void)
+{
+    LayoutBox area = {0, 0, 1000, 500};
+    LayoutBox out[3];
+    int placed = ComputeLayout(LAYOUT_COLUMNS, &area, NULL, 3, NULL, out);
+    ExpectCount("columns", placed, 3);
+    ExpectBox("columns 0", &out[0], 0, 0, 333, 500);
+    ExpectBox("columns 1", &out[1], 333, 0, 333, 500);
+    ExpectBox("columns 2", &out[2], 666, 0, 334, 500);
+}
+static void TestSizeHints(void)
+{
+    LayoutBox area = {0, 0, 1000, 500};
+    LayoutItem items[2];
+    LayoutBox out[2];
+    int placed = 0;
+    memset(items, 0, sizeof(items));
+    items[0].max_width = 300;
+    items[0].max_height = 200;
+    items[1].min_width = 600;
+    placed = ComputeLayout(LAYOUT_COLUMNS, &area, items, 2, NULL, out);
+    ExpectCount("size_hints", placed, 2);
+    ExpectBox("size_hints max", &out[0], 0, 0, 300, 200);
+    ExpectBox("size_hints min", &out[1], 500, 0, 600, 500);
+}
+static void TestUnsupportedMode(void)
+{
+    LayoutBox area = {0, 0, 1000, 500};
+    LayoutBox out[1];
+    ExpectCount("tiling", ComputeLayout(LAYOUT_TILING, &area, NULL, 1, NULL, out), -1);
+    ExpectCount("floating", ComputeLayout(LAYOUT_FLOATING, &area, NULL, 1, NULL, out), -1);
+}
+int main(void)
+{
+    TestMasterStack();
+    TestMasterStackRatios();
+    TestGrid();
+    TestColumns();
+    TestSizeHints();
+    TestUnsupportedMode();
+    if (failures != 0)
+    {
+        fprintf(stderr, "gooey_shell_layout_test: %d failures\n", failures);
+        return 1;
+    }
+    printf("gooey_shell_layout_test: all tests passed\n");
+    return 0;
+}
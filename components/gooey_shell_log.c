@@ -0,0 +1,237 @@
+#include "gooey_shell.h"
+#include "gooey_shell_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <poll.h>
+#include <stdatomic.h>
+#include <sys/eventfd.h>
+#define MAX_LOG_THREADS 8
+#define LOG_RING_SIZE 256
+#define LOG_RECORD_TEXT 240
+typedef struct LogRecord
+{
+    int level;
+    char text[LOG_RECORD_TEXT];
+} LogRecord;
+typedef struct LogRing
+{
+    atomic_size_t head;
+    atomic_size_t tail;
+    atomic_ulong dropped;
+    LogRecord records[LOG_RING_SIZE];
+} LogRing;
+static LogRing log_rings[MAX_LOG_THREADS];
+static atomic_int log_ring_count = 0;
+static atomic_int log_level = LOG_LEVEL_INFO;
+static atomic_int log_running = 0;
+static atomic_int log_flusher_sleeping = 0;
+static int log_wake_fd = -1;
+static gthread_t log_thread;
+static _Thread_local LogRing *log_local_ring = NULL;
+static _Thread_local int log_local_ring_failed = 0;
+static const char *const log_level_tags[] = {"[ERROR] ", "[WARN] ", "[INFO] ", "[DEBUG] "};
+static FILE *GetLogStream(int level)
+{
+    return (level <= LOG_LEVEL_WARN) ? stderr : stdout;
+}
+static void WriteLogRecord(int level, const char *text)
+{
+    FILE *stream = GetLogStream(level);
+    fputs(log_level_tags[level], stream);
+    fputs(text, stream);
+    fputc('\n', stream);
+}
+static LogRing *GetLocalLogRing(void)
+{
+    int index = 0;
+    if ((log_local_ring != NULL) || (log_local_ring_failed != 0))
+    {
+        return log_local_ring;
+    }
+    index = atomic_fetch_add(&log_ring_count, 1);
+    if (index >= MAX_LOG_THREADS)
+    {
+        log_local_ring_failed = 1;
+        return NULL;
+    }
+    log_local_ring = &log_rings[index];
+    return log_local_ring;
+}
+void LogMessage(int level, const char *message, ...)
+{
+    LogRing *ring = NULL;
+    LogRecord *record = NULL;
+    size_t head = 0;
+    size_t tail = 0;
+    va_list args;
+    if ((level < LOG_LEVEL_ERROR) || (level > LOG_LEVEL_DEBUG) ||
+        (level > atomic_load_explicit(&log_level, memory_order_relaxed)))
+    {
+        return;
+    }
+    ring = (atomic_load_explicit(&log_running, memory_order_acquire) != 0) ? GetLocalLogRing() : NULL;
+    if (ring == NULL)
+    {
+        char text[LOG_RECORD_TEXT];
+        va_start(args, message);
+        (void)vsnprintf(text, sizeof(text), message, args);
+        va_end(args);
+        WriteLogRecord(level, text);
+        return;
+    }
+    head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail >= LOG_RING_SIZE)
+    {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return;
+    }
+    record = &ring->records[head & (LOG_RING_SIZE - 1)];
+    record->level = level;
+    va_start(args, message);
+    (void)vsnprintf(record->text, sizeof(record->text), message, args);
+    va_end(args);
+    atomic_store(&ring->head, head + 1);
+    if (atomic_exchange(&log_flusher_sleeping, 0) != 0)
+    {
+        uint64_t one = 1;
+        (void)write(log_wake_fd, &one, sizeof(one));
+    }
+}
+static int DrainLogRings(void)
+{
+    int count = atomic_load(&log_ring_count);
+    int written = 0;
+    int i = 0;
+    if (count > MAX_LOG_THREADS)
+    {
+        count = MAX_LOG_THREADS;
+    }
+    for (i = 0; i < count; i++)
+    {
+        LogRing *ring = &log_rings[i];
+        size_t head = atomic_load(&ring->head);
+        size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        unsigned long dropped = atomic_exchange_explicit(&ring->dropped, 0, memory_order_relaxed);
+        while (tail != head)
+        {
+            const LogRecord *record = &ring->records[tail & (LOG_RING_SIZE - 1)];
+            WriteLogRecord(record->level, record->text);
+            tail++;
+            written++;
+        }
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+        if (dropped != 0)
+        {
+            fprintf(stderr, "[WARN] Logger: Dropped %lu messages\n", dropped);
+            written++;
+        }
+    }
+    if (written != 0)
+    {
+        fflush(stdout);
+        fflush(stderr);
+    }
+    return written;
+}
+static void *LogFlusherThread(void *arg)
+{
+    struct pollfd pfd;
+    uint64_t value = 0;
+    (void)arg;
+    pfd.fd = log_wake_fd;
+    pfd.events = POLLIN;
+    while (atomic_load(&log_running) != 0)
+    {
+        (void)DrainLogRings();
+        atomic_store(&log_flusher_sleeping, 1);
+        if (DrainLogRings() != 0)
+        {
+            atomic_store(&log_flusher_sleeping, 0);
+            continue;
+        }
+        pfd.revents = 0;
+        if ((poll(&pfd, 1, -1) > 0) && ((pfd.revents & POLLIN) != 0))
+        {
+            while (read(log_wake_fd, &value, sizeof(value)) > 0)
+            {
+            }
+        }
+        atomic_store(&log_flusher_sleeping, 0);
+    }
+    (void)DrainLogRings();
+    return NULL;
+}
+static int ParseLogLevel(const char *value)
+{
+    static const char *const names[] = {"error", "warn", "info", "debug"};
+    int i = 0;
+    for (i = 0; i <= LOG_LEVEL_DEBUG; i++)
+    {
+        if (strcasecmp(value, names[i]) == 0)
+        {
+            return i;
+        }
+    }
+    if ((value[0] >= '0') && (value[0] <= '9'))
+    {
+        i = atoi(value);
+        return (i > LOG_LEVEL_DEBUG) ? LOG_LEVEL_DEBUG : i;
+    }
+    return -1;
+}
+void SetLogLevel(int level)
+{
+    if ((level >= LOG_LEVEL_ERROR) && (level <= LOG_LEVEL_DEBUG))
+    {
+        atomic_store(&log_level, level);
+    }
+}
+int GetLogLevel(void)
+{
+    return atomic_load(&log_level);
+}
+int InitializeLogger(void)
+{
+    const char *env_level = getenv("GOOEY_LOG_LEVEL");
+    if ((env_level != NULL) && (ParseLogLevel(env_level) >= 0))
+    {
+        SetLogLevel(ParseLogLevel(env_level));
+    }
+    if (atomic_load(&log_running) != 0)
+    {
+        return 1;
+    }
+    log_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (log_wake_fd < 0)
+    {
+        return 0;
+    }
+    atomic_store(&log_running, 1);
+    if (glps_thread_create(&log_thread, NULL, LogFlusherThread, NULL) != 0)
+    {
+        atomic_store(&log_running, 0);
+        (void)close(log_wake_fd);
+        log_wake_fd = -1;
+        return 0;
+    }
+    (void)atexit(ShutdownLogger);
+    return 1;
+}
+void ShutdownLogger(void)
+{
+    uint64_t one = 1;
+    if (atomic_exchange(&log_running, 0) == 0)
+    {
+        return;
+    }
+    (void)write(log_wake_fd, &one, sizeof(one));
+    glps_thread_join(log_thread, NULL);
+    (void)close(log_wake_fd);
+    log_wake_fd = -1;
+}
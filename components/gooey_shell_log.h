@@ -0,0 +1,31 @@
+#ifndef GOOEY_SHELL_LOG_H
+#define GOOEY_SHELL_LOG_H
+#define LOG_LEVEL_ERROR 0
+#define LOG_LEVEL_WARN 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_DEBUG 3
+#ifndef GOOEY_LOG_COMPILE_LEVEL
+#ifdef NDEBUG
+#define GOOEY_LOG_COMPILE_LEVEL LOG_LEVEL_INFO
+#else
+#define GOOEY_LOG_COMPILE_LEVEL LOG_LEVEL_DEBUG
+#endif
+#endif
+#define LOG_AT_LEVEL(level, ...)                    \
+    do                                              \
+    {                                               \
+        if ((level) <= GOOEY_LOG_COMPILE_LEVEL)     \
+        {                                           \
+            LogMessage((level), __VA_ARGS__);       \
+        }                                           \
+    } while (0)
+#define LogError(...) LOG_AT_LEVEL(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LogWarn(...) LOG_AT_LEVEL(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LogInfo(...) LOG_AT_LEVEL(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LogDebug(...) LOG_AT_LEVEL(LOG_LEVEL_DEBUG, __VA_ARGS__)
+void LogMessage(int level, const char *message, ...) __attribute__((format(printf, 2, 3)));
+int InitializeLogger(void);
+void ShutdownLogger(void);
+void SetLogLevel(int level);
+int GetLogLevel(void);
+#endif
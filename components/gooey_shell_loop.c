@@ -0,0 +1,317 @@
+#include "gooey_shell.h"
+#include "gooey_shell_loop.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#define MAX_EPOLL_EVENTS 32
+unsigned long long GetMonotonicTimeNs(void)
+{
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((unsigned long long)ts.tv_sec * 1000000000ULL) + (unsigned long long)ts.tv_nsec;
+}
+static void FillShellSignalSet(sigset_t *mask)
+{
+    sigemptyset(mask);
+    sigaddset(mask, SIGCHLD);
+    sigaddset(mask, SIGHUP);
+    sigaddset(mask, SIGUSR2);
+}
+void BlockShellSignals(void)
+{
+    sigset_t mask;
+    FillShellSignalSet(&mask);
+    if (sigprocmask(SIG_BLOCK, &mask, NULL) != 0)
+    {
+        LogError("BlockShellSignals: sigprocmask failed: %s", strerror(errno));
+    }
+}
+int WatchFd(GooeyShellState *state, int fd, unsigned int events, ShellFdCallback callback, void *data)
+{
+    struct epoll_event ev;
+    int i = 0;
+    if ((state == NULL) || (state->epoll_fd < 0) || (fd < 0))
+    {
+        return -1;
+    }
+    for (i = 0; i < MAX_SHELL_FD_WATCHES; i++)
+    {
+        if (state->fd_watches[i].fd < 0)
+        {
+            break;
+        }
+    }
+    if (i == MAX_SHELL_FD_WATCHES)
+    {
+        LogError("WatchFd: No free watch slot for fd %d", fd);
+        return -1;
+    }
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.ptr = &state->fd_watches[i];
+    if (epoll_ctl(state->epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0)
+    {
+        LogError("WatchFd: epoll_ctl failed for fd %d: %s", fd, strerror(errno));
+        return -1;
+    }
+    state->fd_watches[i].fd = fd;
+    state->fd_watches[i].callback = callback;
+    state->fd_watches[i].data = data;
+    return 0;
+}
+void UnwatchFd(GooeyShellState *state, int fd)
+{
+    int i = 0;
+    if ((state == NULL) || (state->epoll_fd < 0) || (fd < 0))
+    {
+        return;
+    }
+    for (i = 0; i < MAX_SHELL_FD_WATCHES; i++)
+    {
+        if (state->fd_watches[i].fd == fd)
+        {
+            (void)epoll_ctl(state->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+            state->fd_watches[i].fd = -1;
+            state->fd_watches[i].callback = NULL;
+            state->fd_watches[i].data = NULL;
+            return;
+        }
+    }
+}
+static void ArmTimerFd(GooeyShellState *state)
+{
+    struct itimerspec spec;
+    unsigned long long earliest = 0ULL;
+    int i = 0;
+    if (state->timer_fd < 0)
+    {
+        return;
+    }
+    for (i = 0; i < MAX_SHELL_TIMERS; i++)
+    {
+        if ((state->timers[i].active != 0) &&
+            ((earliest == 0ULL) || (state->timers[i].deadline_ns < earliest)))
+        {
+            earliest = state->timers[i].deadline_ns;
+        }
+    }
+    memset(&spec, 0, sizeof(spec));
+    if (earliest != 0ULL)
+    {
+        spec.it_value.tv_sec = (time_t)(earliest / 1000000000ULL);
+        spec.it_value.tv_nsec = (long)(earliest % 1000000000ULL);
+    }
+    if (timerfd_settime(state->timer_fd, TFD_TIMER_ABSTIME, &spec, NULL) != 0)
+    {
+        LogError("ArmTimerFd: timerfd_settime failed: %s", strerror(errno));
+    }
+}
+int AddTimer(GooeyShellState *state, int delay_ms, ShellTimerCallback callback, void *data)
+{
+    int i = 0;
+    if ((state == NULL) || (callback == NULL))
+    {
+        return -1;
+    }
+    for (i = 0; i < MAX_SHELL_TIMERS; i++)
+    {
+        if (state->timers[i].active == 0)
+        {
+            state->timers[i].deadline_ns = GetMonotonicTimeNs() +
+                                           (unsigned long long)((delay_ms > 0) ? delay_ms : 0) * 1000000ULL;
+            state->timers[i].callback = callback;
+            state->timers[i].data = data;
+            state->timers[i].active = 1;
+            ArmTimerFd(state);
+            return i;
+        }
+    }
+    LogError("AddTimer: No free timer slot");
+    return -1;
+}
+void CancelTimer(GooeyShellState *state, int timer_id)
+{
+    if ((state == NULL) || (timer_id < 0) || (timer_id >= MAX_SHELL_TIMERS))
+    {
+        return;
+    }
+    state->timers[timer_id].active = 0;
+    state->timers[timer_id].callback = NULL;
+    state->timers[timer_id].data = NULL;
+    ArmTimerFd(state);
+}
+static void HandleTimerFd(GooeyShellState *state, int fd, unsigned int events, void *data)
+{
+    uint64_t expirations = 0;
+    unsigned long long now = 0ULL;
+    int i = 0;
+    (void)events;
+    (void)data;
+    while (read(fd, &expirations, sizeof(expirations)) > 0)
+    {
+    }
+    now = GetMonotonicTimeNs();
+    for (i = 0; i < MAX_SHELL_TIMERS; i++)
+    {
+        if ((state->timers[i].active != 0) && (state->timers[i].deadline_ns <= now))
+        {
+            ShellTimerCallback callback = state->timers[i].callback;
+            void *timer_data = state->timers[i].data;
+            state->timers[i].active = 0;
+            state->timers[i].callback = NULL;
+            state->timers[i].data = NULL;
+            callback(state, timer_data);
+        }
+    }
+    ArmTimerFd(state);
+}
+static void HandleSignalFd(GooeyShellState *state, int fd, unsigned int events, void *data)
+{
+    struct signalfd_siginfo info;
+    int child_exited = 0;
+    int reload_requested = 0;
+    int trace_requested = 0;
+    (void)events;
+    (void)data;
+    while (read(fd, &info, sizeof(info)) == (ssize_t)sizeof(info))
+    {
+        if (info.ssi_signo == SIGCHLD)
+        {
+            child_exited = 1;
+        }
+        else if (info.ssi_signo == SIGHUP)
+        {
+            reload_requested = 1;
+        }
+        else if (info.ssi_signo == SIGUSR2)
+        {
+            trace_requested = 1;
+        }
+    }
+    if (child_exited != 0)
+    {
+        ReapChildProcesses(state);
+    }
+    if (reload_requested != 0)
+    {
+        GooeyShell_ReloadConfig(state);
+    }
+    if (trace_requested != 0)
+    {
+        (void)DumpTraceRing(state, NULL);
+    }
+}
+int InitializeEventLoop(GooeyShellState *state)
+{
+    sigset_t mask;
+    int i = 0;
+    if (ValidateWindowState(state) == 0)
+    {
+        return 0;
+    }
+    for (i = 0; i < MAX_SHELL_FD_WATCHES; i++)
+    {
+        state->fd_watches[i].fd = -1;
+    }
+    state->signal_fd = -1;
+    state->timer_fd = -1;
+    state->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (state->epoll_fd < 0)
+    {
+        LogError("InitializeEventLoop: epoll_create1 failed: %s", strerror(errno));
+        return 0;
+    }
+    if (WatchFd(state, ConnectionNumber(state->display), EPOLLIN, NULL, NULL) != 0)
+    {
+        LogError("InitializeEventLoop: Failed to watch X connection");
+        CleanupEventLoop(state);
+        return 0;
+    }
+    FillShellSignalSet(&mask);
+    state->signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if ((state->signal_fd < 0) || (WatchFd(state, state->signal_fd, EPOLLIN, HandleSignalFd, NULL) != 0))
+    {
+        LogError("InitializeEventLoop: Failed to set up signalfd: %s", strerror(errno));
+        CleanupEventLoop(state);
+        return 0;
+    }
+    state->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if ((state->timer_fd < 0) || (WatchFd(state, state->timer_fd, EPOLLIN, HandleTimerFd, NULL) != 0))
+    {
+        LogError("InitializeEventLoop: Failed to set up timerfd: %s", strerror(errno));
+        CleanupEventLoop(state);
+        return 0;
+    }
+    ArmTimerFd(state);
+    return 1;
+}
+void CleanupEventLoop(GooeyShellState *state)
+{
+    int i = 0;
+    if (state == NULL)
+    {
+        return;
+    }
+    for (i = 0; i < MAX_SHELL_TIMERS; i++)
+    {
+        state->timers[i].active = 0;
+    }
+    if (state->signal_fd >= 0)
+    {
+        UnwatchFd(state, state->signal_fd);
+        (void)close(state->signal_fd);
+        state->signal_fd = -1;
+    }
+    if (state->timer_fd >= 0)
+    {
+        UnwatchFd(state, state->timer_fd);
+        (void)close(state->timer_fd);
+        state->timer_fd = -1;
+    }
+    if (state->epoll_fd >= 0)
+    {
+        (void)close(state->epoll_fd);
+        state->epoll_fd = -1;
+    }
+    for (i = 0; i < MAX_SHELL_FD_WATCHES; i++)
+    {
+        state->fd_watches[i].fd = -1;
+    }
+}
+int WaitForLoopEvents(GooeyShellState *state)
+{
+    struct epoll_event events[MAX_EPOLL_EVENTS];
+    int count = 0;
+    int i = 0;
+    if ((state == NULL) || (state->epoll_fd < 0))
+    {
+        return -1;
+    }
+    count = epoll_wait(state->epoll_fd, events, MAX_EPOLL_EVENTS, -1);
+    if (count < 0)
+    {
+        if (errno == EINTR)
+        {
+            return 0;
+        }
+        LogError("WaitForLoopEvents: epoll_wait failed: %s", strerror(errno));
+        return -1;
+    }
+    for (i = 0; i < count; i++)
+    {
+        ShellFdWatch *watch = (ShellFdWatch *)events[i].data.ptr;
+        if ((watch != NULL) && (watch->fd >= 0) && (watch->callback != NULL))
+        {
+            watch->callback(state, watch->fd, events[i].events, watch->data);
+        }
+    }
+    return count;
+}
@@ -0,0 +1,13 @@
+#ifndef GOOEY_SHELL_LOOP_H
+#define GOOEY_SHELL_LOOP_H
+#include "gooey_shell.h"
+int InitializeEventLoop(GooeyShellState *state);
+void CleanupEventLoop(GooeyShellState *state);
+int WatchFd(GooeyShellState *state, int fd, unsigned int events, ShellFdCallback callback, void *data);
+void UnwatchFd(GooeyShellState *state, int fd);
+int AddTimer(GooeyShellState *state, int delay_ms, ShellTimerCallback callback, void *data);
+void CancelTimer(GooeyShellState *state, int timer_id);
+int WaitForLoopEvents(GooeyShellState *state);
+void BlockShellSignals(void);
+unsigned long long GetMonotonicTimeNs(void);
+#endif
@@ -0,0 +1,173 @@
+#include "gooey_shell.h"
+#include "gooey_shell_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#define POOL_SLAB_OBJECTS 64
+#define POOL_ALIGNMENT alignof(max_align_t)
+#define POOL_ROUND_UP(size) ((((size) + POOL_ALIGNMENT - 1) / POOL_ALIGNMENT) * POOL_ALIGNMENT)
+typedef struct PoolSlab
+{
+    struct PoolSlab *next;
+} PoolSlab;
+typedef struct PoolFreeObject
+{
+    struct PoolFreeObject *next;
+} PoolFreeObject;
+typedef struct ObjectPool
+{
+    const char *name;
+    size_t object_size;
+    PoolSlab *slabs;
+    PoolFreeObject *free_list;
+    atomic_ulong slab_count;
+    atomic_ulong in_use;
+    atomic_ulong peak_in_use;
+    atomic_ulong total_allocations;
+} ObjectPool;
+static ObjectPool object_pools[SHELL_POOL_COUNT] = {
+    [SHELL_POOL_TILING_NODE] = {"TilingNode", POOL_ROUND_UP(sizeof(TilingNode)), NULL, NULL, 0, 0, 0, 0},
+    [SHELL_POOL_WINDOW_NODE] = {"WindowNode", POOL_ROUND_UP(sizeof(WindowNode)), NULL, NULL, 0, 0, 0, 0}};
+static int GrowObjectPool(ObjectPool *pool)
+{
+    size_t header = POOL_ROUND_UP(sizeof(PoolSlab));
+    PoolSlab *slab = malloc(header + pool->object_size * POOL_SLAB_OBJECTS);
+    unsigned char *objects = NULL;
+    int i = 0;
+    if (slab == NULL)
+    {
+        LogError("GrowObjectPool: Failed to allocate %s slab", pool->name);
+        return 0;
+    }
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    objects = (unsigned char *)slab + header;
+    for (i = POOL_SLAB_OBJECTS - 1; i >= 0; i--)
+    {
+        PoolFreeObject *object = (PoolFreeObject *)(objects + (size_t)i * pool->object_size);
+        object->next = pool->free_list;
+        pool->free_list = object;
+    }
+    atomic_fetch_add_explicit(&pool->slab_count, 1, memory_order_relaxed);
+    return 1;
+}
+void *PoolAllocate(ShellPoolType type)
+{
+    ObjectPool *pool = NULL;
+    PoolFreeObject *object = NULL;
+    unsigned long in_use = 0;
+    if ((type < 0) || (type >= SHELL_POOL_COUNT))
+    {
+        return NULL;
+    }
+    pool = &object_pools[type];
+    if ((pool->free_list == NULL) && (GrowObjectPool(pool) == 0))
+    {
+        return NULL;
+    }
+    object = pool->free_list;
+    pool->free_list = object->next;
+    memset(object, 0, pool->object_size);
+    in_use = atomic_fetch_add_explicit(&pool->in_use, 1, memory_order_relaxed) + 1;
+    if (in_use > atomic_load_explicit(&pool->peak_in_use, memory_order_relaxed))
+    {
+        atomic_store_explicit(&pool->peak_in_use, in_use, memory_order_relaxed);
+    }
+    atomic_fetch_add_explicit(&pool->total_allocations, 1, memory_order_relaxed);
+    return object;
+}
+void PoolRelease(ShellPoolType type, void *object)
+{
+    ObjectPool *pool = NULL;
+    PoolFreeObject *entry = (PoolFreeObject *)object;
+    if ((object == NULL) || (type < 0) || (type >= SHELL_POOL_COUNT))
+    {
+        return;
+    }
+    pool = &object_pools[type];
+    entry->next = pool->free_list;
+    pool->free_list = entry;
+    atomic_fetch_sub_explicit(&pool->in_use, 1, memory_order_relaxed);
+}
+void LogObjectPoolStats(void)
+{
+    int i = 0;
+    for (i = 0; i < SHELL_POOL_COUNT; i++)
+    {
+        ObjectPool *pool = &object_pools[i];
+        LogInfo("LogObjectPoolStats: %s: %lu slabs, %lu in use, %lu peak, %lu allocations",
+                pool->name,
+                atomic_load_explicit(&pool->slab_count, memory_order_relaxed),
+                atomic_load_explicit(&pool->in_use, memory_order_relaxed),
+                atomic_load_explicit(&pool->peak_in_use, memory_order_relaxed),
+                atomic_load_explicit(&pool->total_allocations, memory_order_relaxed));
+    }
+}
+void FreeObjectPools(void)
+{
+    int i = 0;
+    for (i = 0; i < SHELL_POOL_COUNT; i++)
+    {
+        ObjectPool *pool = &object_pools[i];
+        PoolSlab *slab = pool->slabs;
+        if (atomic_load_explicit(&pool->in_use, memory_order_relaxed) != 0)
+        {
+            LogWarn("FreeObjectPools: %lu %s objects still in use",
+                    atomic_load_explicit(&pool->in_use, memory_order_relaxed), pool->name);
+        }
+        while (slab != NULL)
+        {
+            PoolSlab *next = slab->next;
+            free(slab);
+            slab = next;
+        }
+        pool->slabs = NULL;
+        pool->free_list = NULL;
+        atomic_store_explicit(&pool->slab_count, 0, memory_order_relaxed);
+        atomic_store_explicit(&pool->in_use, 0, memory_order_relaxed);
+    }
+}
+void HandlePoolStatsCommand(GooeyShellState *state, DBusMessage *msg)
+{
+    DBusMessage *reply = NULL;
+    DBusMessageIter args;
+    DBusMessageIter array_iter;
+    int i = 0;
+    if ((state == NULL) || (msg == NULL))
+    {
+        return;
+    }
+    reply = dbus_message_new_method_return(msg);
+    if (reply == NULL)
+    {
+        return;
+    }
+    dbus_message_iter_init_append(reply, &args);
+    dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, "(sttttt)", &array_iter);
+    for (i = 0; i < SHELL_POOL_COUNT; i++)
+    {
+        ObjectPool *pool = &object_pools[i];
+        DBusMessageIter entry;
+        const char *name = pool->name;
+        dbus_uint64_t object_size = (dbus_uint64_t)pool->object_size;
+        dbus_uint64_t slabs = atomic_load_explicit(&pool->slab_count, memory_order_relaxed);
+        dbus_uint64_t in_use = atomic_load_explicit(&pool->in_use, memory_order_relaxed);
+        dbus_uint64_t peak = atomic_load_explicit(&pool->peak_in_use, memory_order_relaxed);
+        dbus_uint64_t allocations = atomic_load_explicit(&pool->total_allocations, memory_order_relaxed);
+        dbus_message_iter_open_container(&array_iter, DBUS_TYPE_STRUCT, NULL, &entry);
+        dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &name);
+        dbus_message_iter_append_basic(&entry, DBUS_TYPE_UINT64, &object_size);
+        dbus_message_iter_append_basic(&entry, DBUS_TYPE_UINT64, &slabs);
+        dbus_message_iter_append_basic(&entry, DBUS_TYPE_UINT64, &in_use);
+        dbus_message_iter_append_basic(&entry, DBUS_TYPE_UINT64, &peak);
+        dbus_message_iter_append_basic(&entry, DBUS_TYPE_UINT64, &allocations);
+        dbus_message_iter_close_container(&array_iter, &entry);
+    }
+    dbus_message_iter_close_container(&args, &array_iter);
+    dbus_connection_send(state->dbus_connection, reply, NULL);
+    dbus_connection_flush(state->dbus_connection);
+    dbus_message_unref(reply);
+}
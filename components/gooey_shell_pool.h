@@ -0,0 +1,9 @@
+#ifndef GOOEY_SHELL_POOL_H
+#define GOOEY_SHELL_POOL_H
+#include "gooey_shell.h"
+void *PoolAllocate(ShellPoolType type);
+void PoolRelease(ShellPoolType type, void *object);
+void FreeObjectPools(void);
+void LogObjectPoolStats(void);
+void HandlePoolStatsCommand(GooeyShellState *state, DBusMessage *msg);
+#endif
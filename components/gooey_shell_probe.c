@@ -0,0 +1,270 @@
+#include "gooey_shell.h"
+#include "gooey_shell_probe.h"
+#include <X11/Xatom.h>
+#include <X11/Xutil.h>
+#include <X11/Xlib-xcb.h>
+#include <xcb/xcb.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#define PROBE_NAME_LENGTH 1024
+#define PROBE_SIZE_HINTS_LENGTH 18
+static xcb_get_property_cookie_t RequestProperty(xcb_connection_t *conn, Window client, Atom property,
+                                                 Atom type, uint32_t length)
+{
+    xcb_get_property_cookie_t cookie;
+    cookie.sequence = 0;
+    if (property != None)
+    {
+        cookie = xcb_get_property(conn, 0, (xcb_window_t)client, (xcb_atom_t)property,
+                                  (xcb_atom_t)type, 0, length);
+    }
+    return cookie;
+}
+static xcb_get_property_reply_t *CollectProperty(xcb_connection_t *conn, xcb_get_property_cookie_t cookie)
+{
+    xcb_generic_error_t *error = NULL;
+    xcb_get_property_reply_t *reply = NULL;
+    if (cookie.sequence == 0)
+    {
+        return NULL;
+    }
+    reply = xcb_get_property_reply(conn, cookie, &error);
+    free(error);
+    return reply;
+}
+static int PropertyExists(xcb_get_property_reply_t *reply)
+{
+    return ((reply != NULL) && (reply->type != XCB_NONE)) ? 1 : 0;
+}
+static char *PropertyString(xcb_get_property_reply_t *reply)
+{
+    char *value = NULL;
+    int length = 0;
+    if ((reply == NULL) || (reply->type == XCB_NONE) || (reply->format != 8))
+    {
+        return NULL;
+    }
+    length = xcb_get_property_value_length(reply);
+    value = malloc((size_t)length + 1);
+    if (value == NULL)
+    {
+        return NULL;
+    }
+    memcpy(value, xcb_get_property_value(reply), (size_t)length);
+    value[length] = '\0';
+    return value;
+}
+static char *Latin1ToUtf8(const char *text)
+{
+    const unsigned char *src = (const unsigned char *)text;
+    char *value = malloc(strlen(text) * 2 + 1);
+    char *dst = value;
+    if (value == NULL)
+    {
+        return NULL;
+    }
+    for (; *src != '\0'; src++)
+    {
+        if (*src < 0x80)
+        {
+            *dst++ = (char)*src;
+        }
+        else
+        {
+            *dst++ = (char)(0xC0 | (*src >> 6));
+            *dst++ = (char)(0x80 | (*src & 0x3F));
+        }
+    }
+    *dst = '\0';
+    return value;
+}
+static void SanitizeUtf8(char *text)
+{
+    char *p = NULL;
+    if ((text == NULL) || (dbus_validate_utf8(text, NULL) != 0))
+    {
+        return;
+    }
+    for (p = text; *p != '\0'; p++)
+    {
+        if ((unsigned char)*p >= 0x80)
+        {
+            *p = '?';
+        }
+    }
+}
+static char *PropertyTitle(xcb_get_property_reply_t *net_name, xcb_get_property_reply_t *name)
+{
+    char *title = PropertyString(net_name);
+    char *converted = NULL;
+    if (title == NULL)
+    {
+        title = PropertyString(name);
+        if ((title != NULL) && (name->type == XCB_ATOM_STRING))
+        {
+            converted = Latin1ToUtf8(title);
+            if (converted != NULL)
+            {
+                free(title);
+                title = converted;
+            }
+        }
+    }
+    SanitizeUtf8(title);
+    return title;
+}
+static void ReadSizeHints(xcb_get_property_reply_t *reply, WindowProbe *probe)
+{
+    const uint32_t *hints = NULL;
+    if ((reply == NULL) || (reply->format != 32) ||
+        (xcb_get_property_value_length(reply) < (int)(sizeof(uint32_t) * 9)))
+    {
+        return;
+    }
+    hints = (const uint32_t *)xcb_get_property_value(reply);
+    if ((hints[0] & PMinSize) != 0U)
+    {
+        probe->min_width = (int)hints[5];
+        probe->min_height = (int)hints[6];
+    }
+    if ((hints[0] & PMaxSize) != 0U)
+    {
+        probe->max_width = (int)hints[7];
+        probe->max_height = (int)hints[8];
+    }
+}
+int ProbeWindow(GooeyShellState *state, Window client, WindowProbe *probe)
+{
+    xcb_connection_t *conn = NULL;
+    xcb_get_window_attributes_cookie_t attr_cookie;
+    xcb_get_geometry_cookie_t geometry_cookie;
+    xcb_get_property_cookie_t desktop_cookie;
+    xcb_get_property_cookie_t fullscreen_cookie;
+    xcb_get_property_cookie_t stay_on_top_cookie;
+    xcb_get_property_cookie_t type_cookie;
+    xcb_get_property_cookie_t net_name_cookie;
+    xcb_get_property_cookie_t name_cookie;
+    xcb_get_property_cookie_t class_cookie;
+    xcb_get_property_cookie_t hints_cookie;
+    xcb_get_window_attributes_reply_t *attr_reply = NULL;
+    xcb_get_geometry_reply_t *geometry_reply = NULL;
+    xcb_get_property_reply_t *reply = NULL;
+    xcb_get_property_reply_t *net_name_reply = NULL;
+    xcb_generic_error_t *error = NULL;
+    if ((ValidateWindowState(state) == 0) || (probe == NULL))
+    {
+        return 0;
+    }
+    memset(probe, 0, sizeof(*probe));
+    probe->window_type = None;
+    conn = XGetXCBConnection(state->display);
+    if (conn == NULL)
+    {
+        LogError("ProbeWindow: No XCB connection for display");
+        return 0;
+    }
+    attr_cookie = xcb_get_window_attributes(conn, (xcb_window_t)client);
+    geometry_cookie = xcb_get_geometry(conn, (xcb_drawable_t)client);
+    desktop_cookie = RequestProperty(conn, client, atoms.gooey_desktop_app, XA_STRING, 1);
+    fullscreen_cookie = RequestProperty(conn, client, atoms.gooey_fullscreen_app, XA_STRING, 1);
+    stay_on_top_cookie = RequestProperty(conn, client, atoms.gooey_stay_on_top, XA_STRING, 1);
+    type_cookie = RequestProperty(conn, client, atoms.net_wm_window_type, XA_ATOM, 1);
+    net_name_cookie = RequestProperty(conn, client, atoms.net_wm_name, atoms.utf8_string, PROBE_NAME_LENGTH / 4);
+    name_cookie = RequestProperty(conn, client, XA_WM_NAME, AnyPropertyType, PROBE_NAME_LENGTH / 4);
+    class_cookie = RequestProperty(conn, client, XA_WM_CLASS, XA_STRING, PROBE_NAME_LENGTH / 4);
+    hints_cookie = RequestProperty(conn, client, XA_WM_NORMAL_HINTS, XA_WM_SIZE_HINTS, PROBE_SIZE_HINTS_LENGTH);
+    attr_reply = xcb_get_window_attributes_reply(conn, attr_cookie, &error);
+    free(error);
+    error = NULL;
+    geometry_reply = xcb_get_geometry_reply(conn, geometry_cookie, &error);
+    free(error);
+    if ((attr_reply != NULL) && (geometry_reply != NULL))
+    {
+        probe->valid = 1;
+        probe->override_redirect = (attr_reply->override_redirect != 0) ? 1 : 0;
+        probe->x = geometry_reply->x;
+        probe->y = geometry_reply->y;
+        probe->width = geometry_reply->width;
+        probe->height = geometry_reply->height;
+    }
+    free(attr_reply);
+    free(geometry_reply);
+    reply = CollectProperty(conn, desktop_cookie);
+    probe->has_desktop_property = PropertyExists(reply);
+    free(reply);
+    reply = CollectProperty(conn, fullscreen_cookie);
+    probe->has_fullscreen_property = PropertyExists(reply);
+    free(reply);
+    reply = CollectProperty(conn, stay_on_top_cookie);
+    probe->has_stay_on_top_property = PropertyExists(reply);
+    free(reply);
+    reply = CollectProperty(conn, type_cookie);
+    if ((reply != NULL) && (reply->format == 32) && (xcb_get_property_value_length(reply) >= 4))
+    {
+        probe->window_type = (Atom)((xcb_atom_t *)xcb_get_property_value(reply))[0];
+    }
+    free(reply);
+    net_name_reply = CollectProperty(conn, net_name_cookie);
+    reply = CollectProperty(conn, name_cookie);
+    probe->title = PropertyTitle(net_name_reply, reply);
+    free(net_name_reply);
+    free(reply);
+    reply = CollectProperty(conn, class_cookie);
+    probe->res_name = PropertyString(reply);
+    free(reply);
+    reply = CollectProperty(conn, hints_cookie);
+    ReadSizeHints(reply, probe);
+    free(reply);
+    return probe->valid;
+}
+void FreeWindowProbe(WindowProbe *probe)
+{
+    if (probe == NULL)
+    {
+        return;
+    }
+    free(probe->title);
+    free(probe->res_name);
+    probe->title = NULL;
+    probe->res_name = NULL;
+}
+void ClassifyWindowProbe(const WindowProbe *probe, int *is_desktop, int *is_fullscreen, int *stay_on_top)
+{
+    *is_desktop = 0;
+    *is_fullscreen = 0;
+    *stay_on_top = 0;
+    if (probe == NULL)
+    {
+        return;
+    }
+    if ((probe->has_desktop_property != 0) ||
+        ((probe->window_type != None) && (probe->window_type == atoms.net_wm_window_type_desktop)))
+    {
+        *is_desktop = 1;
+        return;
+    }
+    if (probe->has_fullscreen_property != 0)
+    {
+        *is_fullscreen = 1;
+        *stay_on_top = probe->has_stay_on_top_property;
+        return;
+    }
+    if ((probe->window_type != None) &&
+        ((probe->window_type == atoms.net_wm_window_type_dock) ||
+         (probe->window_type == atoms.net_wm_window_type_toolbar) ||
+         (probe->window_type == atoms.net_wm_window_type_menu)))
+    {
+        *is_fullscreen = 1;
+        *stay_on_top = 1;
+        return;
+    }
+    if ((probe->title != NULL) && (MatchTitleAppType(probe->title, is_desktop, is_fullscreen, stay_on_top) != 0))
+    {
+        return;
+    }
+    if (probe->res_name != NULL)
+    {
+        (void)MatchClassAppType(probe->res_name, is_desktop, is_fullscreen, stay_on_top);
+    }
+}
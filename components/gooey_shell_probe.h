@@ -0,0 +1,7 @@
+#ifndef GOOEY_SHELL_PROBE_H
+#define GOOEY_SHELL_PROBE_H
+#include "gooey_shell.h"
+int ProbeWindow(GooeyShellState *state, Window client, WindowProbe *probe);
+void FreeWindowProbe(WindowProbe *probe);
+void ClassifyWindowProbe(const WindowProbe *probe, int *is_desktop, int *is_fullscreen, int *stay_on_top);
+#endif
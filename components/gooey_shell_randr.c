@@ -0,0 +1,256 @@
+#include "gooey_shell.h"
+#include "gooey_shell_randr.h"
+#include <X11/extensions/Xrandr.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+int HandleRandrEvent(GooeyShellState *state, XEvent *ev)
+{
+    if ((state == NULL) || (ev == NULL) || (state->has_randr == 0))
+    {
+        return 0;
+    }
+    if (ev->type == state->randr_event_base + RRScreenChangeNotify)
+    {
+        (void)XRRUpdateConfiguration(ev);
+        state->monitor_refresh_pending = 1;
+        return 1;
+    }
+    if (ev->type == state->randr_event_base + RRNotify)
+    {
+        state->monitor_refresh_pending = 1;
+        return 1;
+    }
+    return 0;
+}
+static int FindMatchingMonitor(const Monitor *old_mon, const Monitor *monitors, int count, const int *new_to_old)
+{
+    int i = 0;
+    for (i = 0; i < count; i++)
+    {
+        if ((new_to_old[i] < 0) && (old_mon->crtc != None) && (monitors[i].crtc == old_mon->crtc))
+        {
+            return i;
+        }
+    }
+    for (i = 0; i < count; i++)
+    {
+        if ((new_to_old[i] < 0) && (monitors[i].x == old_mon->x) && (monitors[i].y == old_mon->y))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+static int MonitorGeometryEqual(const Monitor *a, const Monitor *b)
+{
+    return ((a->x == b->x) && (a->y == b->y) && (a->width == b->width) && (a->height == b->height)) ? 1 : 0;
+}
+static int RemapWorkspaceMonitors(Workspace *ws, const int *old_to_new, int old_count, int new_count)
+{
+    TilingNode **roots = calloc((size_t)new_count, sizeof(TilingNode *));
+    StackRatios *stacks = calloc((size_t)new_count, sizeof(StackRatios));
+    int i = 0;
+    if ((roots == NULL) || (stacks == NULL))
+    {
+        LogError("RemapWorkspaceMonitors: Failed to allocate tiling roots for workspace %d", ws->number);
+        free(roots);
+        free(stacks);
+        return 0;
+    }
+    for (i = 0; (i < ws->monitor_tiling_roots_count) && (ws->monitor_tiling_roots != NULL); i++)
+    {
+        if ((i < old_count) && (old_to_new[i] >= 0))
+        {
+            roots[old_to_new[i]] = ws->monitor_tiling_roots[i];
+            if (ws->monitor_stack_ratios != NULL)
+            {
+                stacks[old_to_new[i]] = ws->monitor_stack_ratios[i];
+            }
+        }
+        else
+        {
+            if (ws->monitor_tiling_roots[i] != NULL)
+            {
+                FreeTilingTree(ws->monitor_tiling_roots[i]);
+            }
+            if (ws->monitor_stack_ratios != NULL)
+            {
+                free(ws->monitor_stack_ratios[i].ratios);
+            }
+        }
+    }
+    free(ws->monitor_tiling_roots);
+    free(ws->monitor_stack_ratios);
+    ws->monitor_tiling_roots = roots;
+    ws->monitor_stack_ratios = stacks;
+    ws->monitor_tiling_roots_count = new_count;
+    return 1;
+}
+static void ClampFloatingWindow(const Monitor *mon, WindowNode *node, int bar_height)
+{
+    int frame_width = node->width + 2 * BORDER_WIDTH;
+    int frame_height = node->height + TITLE_BAR_HEIGHT + 2 * BORDER_WIDTH;
+    if (node->x + frame_width > mon->x + mon->width)
+    {
+        node->x = mon->x + mon->width - frame_width;
+    }
+    if (node->y + frame_height > mon->y + mon->height)
+    {
+        node->y = mon->y + mon->height - frame_height;
+    }
+    if (node->x < mon->x)
+    {
+        node->x = mon->x;
+    }
+    if (node->y < mon->y + bar_height)
+    {
+        node->y = mon->y + bar_height;
+    }
+    node->floating_x = node->x;
+    node->floating_y = node->y;
+}
+static void MigrateWindows(GooeyShellState *state, const int *old_to_new, int old_count, int *changed)
+{
+    int i = 0;
+    for (i = 0; i < state->window_index_capacity; i++)
+    {
+        WindowIndexEntry *slot = &state->window_index[i];
+        WindowNode *node = slot->node;
+        int target = 0;
+        if ((node == NULL) || (slot->key != node->frame))
+        {
+            continue;
+        }
+        if ((node->monitor_number >= 0) && (node->monitor_number < old_count))
+        {
+            target = old_to_new[node->monitor_number];
+        }
+        else
+        {
+            target = -1;
+        }
+        if (target < 0)
+        {
+            target = 0;
+            changed[target] = 1;
+        }
+        node->monitor_number = target;
+        if (changed[target] == 0)
+        {
+            continue;
+        }
+        if ((node->is_floating != 0) && (node->is_desktop_app == 0) && (node->is_fullscreen_app == 0))
+        {
+            ClampFloatingWindow(&state->monitor_info.monitors[target], node, (target == 0) ? BAR_HEIGHT : 0);
+        }
+        UpdateWindowGeometry(state, node);
+    }
+}
+void ApplyMonitorChanges(GooeyShellState *state)
+{
+    Monitor *old_monitors = NULL;
+    Monitor *monitors = NULL;
+    Workspace *ws = NULL;
+    int old_count = 0;
+    int count = 0;
+    int *old_to_new = NULL;
+    int *new_to_old = NULL;
+    int *changed = NULL;
+    int any_change = 0;
+    int i = 0;
+    if ((ValidateWindowState(state) == 0) || (state->monitor_refresh_pending == 0))
+    {
+        return;
+    }
+    state->monitor_refresh_pending = 0;
+    monitors = QueryMonitors(state, 1, &count);
+    if (monitors == NULL)
+    {
+        return;
+    }
+    old_monitors = state->monitor_info.monitors;
+    old_count = state->monitor_info.num_monitors;
+    old_to_new = calloc((size_t)((old_count > 0) ? old_count : 1), sizeof(int));
+    new_to_old = calloc((size_t)count, sizeof(int));
+    changed = calloc((size_t)count, sizeof(int));
+    if ((old_to_new == NULL) || (new_to_old == NULL) || (changed == NULL))
+    {
+        LogError("ApplyMonitorChanges: Failed to allocate monitor maps");
+        free(old_to_new);
+        free(new_to_old);
+        free(changed);
+        free(monitors);
+        return;
+    }
+    for (i = 0; i < count; i++)
+    {
+        new_to_old[i] = -1;
+    }
+    for (i = 0; i < old_count; i++)
+    {
+        old_to_new[i] = FindMatchingMonitor(&old_monitors[i], monitors, count, new_to_old);
+        if (old_to_new[i] >= 0)
+        {
+            new_to_old[old_to_new[i]] = i;
+        }
+    }
+    for (i = 0; i < count; i++)
+    {
+        if (new_to_old[i] < 0)
+        {
+            changed[i] = 1;
+        }
+        else
+        {
+            changed[i] = (MonitorGeometryEqual(&old_monitors[new_to_old[i]], &monitors[i]) == 0) ? 1 : 0;
+            if (new_to_old[i] != i)
+            {
+                any_change = 1;
+            }
+        }
+        if (changed[i] != 0)
+        {
+            any_change = 1;
+        }
+    }
+    if ((any_change == 0) && (count == old_count))
+    {
+        free(old_to_new);
+        free(new_to_old);
+        free(changed);
+        free(monitors);
+        return;
+    }
+    LogInfo("ApplyMonitorChanges: Monitor layout changed (%d -> %d monitors)", old_count, count);
+    state->monitor_info.monitors = monitors;
+    state->monitor_info.num_monitors = count;
+    state->monitor_info.primary_monitor = 0;
+    free(old_monitors);
+    if ((state->focused_monitor < 0) || (state->focused_monitor >= count))
+    {
+        state->focused_monitor = 0;
+    }
+    for (ws = state->workspaces; ws != NULL; ws = ws->next)
+    {
+        (void)RemapWorkspaceMonitors(ws, old_to_new, old_count, count);
+    }
+    MigrateWindows(state, old_to_new, old_count, changed);
+    state->snapshot_dirty = 1;
+    SyncDesktopApps(state, new_to_old, count);
+    ws = GetCurrentWorkspace(state);
+    if (ws != NULL)
+    {
+        for (i = 0; i < count; i++)
+        {
+            if (changed[i] == 0)
+            {
+                continue;
+            }
+            ArrangeWindowsOnMonitor(state, ws, i);
+        }
+    }
+    free(old_to_new);
+    free(new_to_old);
+    free(changed);
+}
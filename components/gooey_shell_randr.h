@@ -0,0 +1,6 @@
+#ifndef GOOEY_SHELL_RANDR_H
+#define GOOEY_SHELL_RANDR_H
+#include "gooey_shell.h"
+int HandleRandrEvent(GooeyShellState *state, XEvent *ev);
+void ApplyMonitorChanges(GooeyShellState *state);
+#endif
@@ -0,0 +1,221 @@
+#include "gooey_shell.h"
+#include "gooey_shell_signals.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+static int SignalsEnabled(GooeyShellState *state)
+{
+    return ((state->dbus_connection != NULL) && (state->is_dbus_init != 0)) ? 1 : 0;
+}
+void EmitShellSignal(GooeyShellState *state, DBusMessage *message)
+{
+    unsigned long long span_start = GetMonotonicTimeNs();
+    if (message == NULL)
+    {
+        return;
+    }
+    dbus_connection_send(state->dbus_connection, message, NULL);
+    dbus_message_unref(message);
+    WakeDBusThread();
+    TraceSpan(state, "EmitShellSignal", span_start, None);
+}
+static WindowStateDelta *FindPendingWindowState(GooeyShellState *state, Window window)
+{
+    int i = 0;
+    for (i = 0; i < state->pending_window_state_count; i++)
+    {
+        if (state->pending_window_states[i].window == window)
+        {
+            return &state->pending_window_states[i];
+        }
+    }
+    return NULL;
+}
+void QueueWindowStateSignal(GooeyShellState *state, Window window, const char *state_str)
+{
+    WindowStateDelta *delta = NULL;
+    if ((state == NULL) || (window == None) || (state_str == NULL))
+    {
+        return;
+    }
+    state->snapshot_dirty = 1;
+    if (SignalsEnabled(state) == 0)
+    {
+        return;
+    }
+    delta = FindPendingWindowState(state, window);
+    if (delta != NULL)
+    {
+        if ((strcmp(state_str, "closed") == 0) && (delta->opened != 0))
+        {
+            *delta = state->pending_window_states[state->pending_window_state_count - 1];
+            state->pending_window_state_count--;
+        }
+        else
+        {
+            if (strcmp(state_str, "opened") == 0)
+            {
+                delta->opened = 1;
+            }
+            if ((strcmp(state_str, "focused") != 0) || (strcmp(delta->state_str, "opened") != 0))
+            {
+                delta->state_str = state_str;
+            }
+        }
+        return;
+    }
+    if (state->pending_window_state_count >= state->pending_window_state_capacity)
+    {
+        int capacity = (state->pending_window_state_capacity == 0) ? 16 : state->pending_window_state_capacity * 2;
+        WindowStateDelta *deltas = realloc(state->pending_window_states, sizeof(WindowStateDelta) * (size_t)capacity);
+        if (deltas == NULL)
+        {
+            LogError("QueueWindowStateSignal: Failed to grow signal queue");
+            return;
+        }
+        state->pending_window_states = deltas;
+        state->pending_window_state_capacity = capacity;
+    }
+    delta = &state->pending_window_states[state->pending_window_state_count++];
+    delta->window = window;
+    delta->state_str = state_str;
+    delta->opened = (strcmp(state_str, "opened") == 0) ? 1 : 0;
+}
+void QueueWorkspaceChangedSignal(GooeyShellState *state, int old_workspace, int new_workspace)
+{
+    if ((state == NULL) || (SignalsEnabled(state) == 0))
+    {
+        return;
+    }
+    if (state->workspace_signal_pending == 0)
+    {
+        state->pending_workspace_old = old_workspace;
+        state->workspace_signal_pending = 1;
+    }
+    state->pending_workspace_new = new_workspace;
+}
+static int DeltaNeedsOpened(const WindowStateDelta *delta)
+{
+    return ((delta->opened != 0) && (strcmp(delta->state_str, "opened") != 0)) ? 1 : 0;
+}
+static void EmitWindowStateChanged(GooeyShellState *state, Window window, const char *state_str)
+{
+    DBusMessage *message = NULL;
+    DBusMessageIter args;
+    char window_id[32];
+    const char *window_str = window_id;
+    message = dbus_message_new_signal("/dev/binaryink/gshell", "dev.binaryink.gshell", "WindowStateChanged");
+    if (message == NULL)
+    {
+        return;
+    }
+    (void)snprintf(window_id, sizeof(window_id), "%lu", window);
+    dbus_message_iter_init_append(message, &args);
+    dbus_message_iter_append_basic(&args, DBUS_TYPE_STRING, &window_str);
+    dbus_message_iter_append_basic(&args, DBUS_TYPE_STRING, &state_str);
+    EmitShellSignal(state, message);
+}
+static void AppendWindowsChangedEntry(DBusMessageIter *array_iter, Window window, const char *state_str)
+{
+    DBusMessageIter entry;
+    char window_id[32];
+    const char *window_str = window_id;
+    (void)snprintf(window_id, sizeof(window_id), "%lu", window);
+    dbus_message_iter_open_container(array_iter, DBUS_TYPE_STRUCT, NULL, &entry);
+    dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &window_str);
+    dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &state_str);
+    dbus_message_iter_close_container(array_iter, &entry);
+}
+static void EmitWindowsChanged(GooeyShellState *state)
+{
+    DBusMessage *message = NULL;
+    DBusMessageIter args;
+    DBusMessageIter array_iter;
+    int i = 0;
+    message = dbus_message_new_signal("/dev/binaryink/gshell", "dev.binaryink.gshell", "WindowsChanged");
+    if (message == NULL)
+    {
+        return;
+    }
+    dbus_message_iter_init_append(message, &args);
+    dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, "(ss)", &array_iter);
+    for (i = 0; i < state->pending_window_state_count; i++)
+    {
+        const WindowStateDelta *delta = &state->pending_window_states[i];
+        if (DeltaNeedsOpened(delta) != 0)
+        {
+            AppendWindowsChangedEntry(&array_iter, delta->window, "opened");
+        }
+        AppendWindowsChangedEntry(&array_iter, delta->window, delta->state_str);
+    }
+    dbus_message_iter_close_container(&args, &array_iter);
+    EmitShellSignal(state, message);
+}
+static void EmitWorkspaceChanged(GooeyShellState *state)
+{
+    DBusMessage *message = NULL;
+    DBusMessageIter args;
+    dbus_int32_t old_workspace = state->pending_workspace_old;
+    dbus_int32_t new_workspace = state->pending_workspace_new;
+    message = dbus_message_new_signal("/dev/binaryink/gshell", "dev.binaryink.gshell", "WorkspaceChanged");
+    if (message == NULL)
+    {
+        return;
+    }
+    dbus_message_iter_init_append(message, &args);
+    dbus_message_iter_append_basic(&args, DBUS_TYPE_INT32, &old_workspace);
+    dbus_message_iter_append_basic(&args, DBUS_TYPE_INT32, &new_workspace);
+    EmitShellSignal(state, message);
+}
+void FlushPendingSignals(GooeyShellState *state)
+{
+    int i = 0;
+    if (state == NULL)
+    {
+        return;
+    }
+    if (state->focus_signal_pending != 0)
+    {
+        state->focus_signal_pending = 0;
+        QueueWindowStateSignal(state, state->focused_window, "focused");
+    }
+    if (SignalsEnabled(state) == 0)
+    {
+        state->pending_window_state_count = 0;
+        state->workspace_signal_pending = 0;
+        return;
+    }
+    if (state->workspace_signal_pending != 0)
+    {
+        state->workspace_signal_pending = 0;
+        if (state->pending_workspace_old != state->pending_workspace_new)
+        {
+            EmitWorkspaceChanged(state);
+        }
+    }
+    if (state->pending_window_state_count == 0)
+    {
+        return;
+    }
+    for (i = 0; i < state->pending_window_state_count; i++)
+    {
+        const WindowStateDelta *delta = &state->pending_window_states[i];
+        if (DeltaNeedsOpened(delta) != 0)
+        {
+            EmitWindowStateChanged(state, delta->window, "opened");
+        }
+        EmitWindowStateChanged(state, delta->window, delta->state_str);
+    }
+    EmitWindowsChanged(state);
+    state->pending_window_state_count = 0;
+}
+void FreePendingSignals(GooeyShellState *state)
+{
+    if (state == NULL)
+    {
+        return;
+    }
+    SAFE_FREE(state->pending_window_states);
+    state->pending_window_state_count = 0;
+    state->pending_window_state_capacity = 0;
+}
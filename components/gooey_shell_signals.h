@@ -0,0 +1,9 @@
+#ifndef GOOEY_SHELL_SIGNALS_H
+#define GOOEY_SHELL_SIGNALS_H
+#include "gooey_shell.h"
+void EmitShellSignal(GooeyShellState *state, DBusMessage *message);
+void QueueWindowStateSignal(GooeyShellState *state, Window window, const char *state_str);
+void QueueWorkspaceChangedSignal(GooeyShellState *state, int old_workspace, int new_workspace);
+void FlushPendingSignals(GooeyShellState *state);
+void FreePendingSignals(GooeyShellState *state);
+#endif
@@ -0,0 +1,287 @@
+#include "gooey_shell.h"
+#include "gooey_shell_snapshot.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+static int CompareSnapshotEntries(const void *a, const void *b)
+{
+    const WindowSnapshotEntry *lhs = (const WindowSnapshotEntry *)a;
+    const WindowSnapshotEntry *rhs = (const WindowSnapshotEntry *)b;
+    if (lhs->id < rhs->id)
+    {
+        return -1;
+    }
+    return (lhs->id > rhs->id) ? 1 : 0;
+}
+static unsigned int GetSnapshotFlags(GooeyShellState *state, const WindowNode *node)
+{
+    unsigned int flags = 0;
+    flags |= (node->is_minimized != 0) ? WINDOW_SNAPSHOT_MINIMIZED : 0U;
+    flags |= (node->is_floating != 0) ? WINDOW_SNAPSHOT_FLOATING : 0U;
+    flags |= (node->is_fullscreen != 0) ? WINDOW_SNAPSHOT_FULLSCREEN : 0U;
+    flags |= (node->frame == state->focused_window) ? WINDOW_SNAPSHOT_FOCUSED : 0U;
+    flags |= (node->is_fullscreen_app != 0) ? WINDOW_SNAPSHOT_FULLSCREEN_APP : 0U;
+    return flags;
+}
+static int SnapshotEntryEqual(const WindowSnapshotEntry *a, const WindowSnapshotEntry *b)
+{
+    if ((a->workspace != b->workspace) || (a->monitor != b->monitor) || (a->flags != b->flags))
+    {
+        return 0;
+    }
+    return (strcmp((a->title != NULL) ? a->title : "", (b->title != NULL) ? b->title : "") == 0) ? 1 : 0;
+}
+static int SnapshotContainsNewer(GooeyShellState *state, unsigned long long id, unsigned long long generation)
+{
+    WindowSnapshotEntry key;
+    const WindowSnapshotEntry *entry = NULL;
+    key.id = id;
+    entry = bsearch(&key, state->snapshot_entries, (size_t)state->snapshot_count, sizeof(WindowSnapshotEntry),
+                    CompareSnapshotEntries);
+    return ((entry != NULL) && (entry->generation >= generation)) ? 1 : 0;
+}
+static void RecordSnapshotRemoval(GooeyShellState *state, unsigned long long id, unsigned long long generation)
+{
+    WindowSnapshotRemoval *removal = &state->snapshot_removals[state->snapshot_removal_next];
+    if (state->snapshot_removal_count == MAX_SNAPSHOT_REMOVALS)
+    {
+        state->snapshot_history_start = removal->generation;
+    }
+    else
+    {
+        state->snapshot_removal_count++;
+    }
+    removal->id = id;
+    removal->generation = generation;
+    state->snapshot_removal_next = (state->snapshot_removal_next + 1) % MAX_SNAPSHOT_REMOVALS;
+}
+static int CollectSnapshotEntries(GooeyShellState *state, WindowSnapshotEntry **out)
+{
+    WindowSnapshotEntry *entries = NULL;
+    WindowNode *node = NULL;
+    int count = 0;
+    int capacity = 0;
+    for (node = state->window_list; node != NULL; node = node->next)
+    {
+        if (node->is_desktop_app == 0)
+        {
+            capacity++;
+        }
+    }
+    entries = calloc((size_t)((capacity > 0) ? capacity : 1), sizeof(WindowSnapshotEntry));
+    if (entries == NULL)
+    {
+        return -1;
+    }
+    for (node = state->window_list; (node != NULL) && (count < capacity); node = node->next)
+    {
+        if (node->is_desktop_app != 0)
+        {
+            continue;
+        }
+        entries[count].id = (unsigned long long)node->frame;
+        entries[count].title = node->title;
+        entries[count].workspace = node->workspace;
+        entries[count].monitor = node->monitor_number;
+        entries[count].flags = GetSnapshotFlags(state, node);
+        count++;
+    }
+    qsort(entries, (size_t)count, sizeof(WindowSnapshotEntry), CompareSnapshotEntries);
+    *out = entries;
+    return count;
+}
+void PublishWindowSnapshot(GooeyShellState *state)
+{
+    WindowSnapshotEntry *entries = NULL;
+    WindowSnapshotEntry *old_entries = NULL;
+    unsigned long long generation = 0ULL;
+    int old_count = 0;
+    int count = 0;
+    int changed = 0;
+    int i = 0;
+    int j = 0;
+    if ((state == NULL) || (state->snapshot_dirty == 0))
+    {
+        return;
+    }
+    state->snapshot_dirty = 0;
+    count = CollectSnapshotEntries(state, &entries);
+    if (count < 0)
+    {
+        LogError("PublishWindowSnapshot: Failed to allocate snapshot");
+        return;
+    }
+    old_entries = state->snapshot_entries;
+    old_count = state->snapshot_count;
+    generation = state->snapshot_generation + 1;
+    glps_thread_mutex_lock(&window_list_mutex);
+    while ((i < count) || (j < old_count))
+    {
+        if ((j == old_count) || ((i < count) && (entries[i].id < old_entries[j].id)))
+        {
+            entries[i].title = StrDup((entries[i].title != NULL) ? entries[i].title : "");
+            entries[i].generation = generation;
+            changed = 1;
+            i++;
+        }
+        else if ((i == count) || (old_entries[j].id < entries[i].id))
+        {
+            RecordSnapshotRemoval(state, old_entries[j].id, generation);
+            changed = 1;
+            j++;
+        }
+        else
+        {
+            if (SnapshotEntryEqual(&entries[i], &old_entries[j]) != 0)
+            {
+                entries[i].title = old_entries[j].title;
+                entries[i].generation = old_entries[j].generation;
+                old_entries[j].title = NULL;
+            }
+            else
+            {
+                entries[i].title = StrDup((entries[i].title != NULL) ? entries[i].title : "");
+                entries[i].generation = generation;
+                changed = 1;
+            }
+            i++;
+            j++;
+        }
+    }
+    state->snapshot_entries = entries;
+    state->snapshot_count = count;
+    if (changed != 0)
+    {
+        state->snapshot_generation = generation;
+    }
+    glps_thread_mutex_unlock(&window_list_mutex);
+    for (j = 0; j < old_count; j++)
+    {
+        free(old_entries[j].title);
+    }
+    free(old_entries);
+}
+void FreeWindowSnapshot(GooeyShellState *state)
+{
+    int i = 0;
+    if (state == NULL)
+    {
+        return;
+    }
+    glps_thread_mutex_lock(&window_list_mutex);
+    for (i = 0; i < state->snapshot_count; i++)
+    {
+        free(state->snapshot_entries[i].title);
+    }
+    SAFE_FREE(state->snapshot_entries);
+    state->snapshot_count = 0;
+    state->snapshot_removal_count = 0;
+    glps_thread_mutex_unlock(&window_list_mutex);
+}
+static void AppendSnapshotEntry(DBusMessageIter *array_iter, const WindowSnapshotEntry *entry)
+{
+    DBusMessageIter item;
+    dbus_uint64_t id = entry->id;
+    const char *title = ((entry->title != NULL) && (dbus_validate_utf8(entry->title, NULL) != 0)) ? entry->title : "";
+    dbus_int32_t workspace = entry->workspace;
+    dbus_int32_t monitor = entry->monitor;
+    dbus_uint32_t flags = entry->flags;
+    dbus_message_iter_open_container(array_iter, DBUS_TYPE_STRUCT, NULL, &item);
+    dbus_message_iter_append_basic(&item, DBUS_TYPE_UINT64, &id);
+    dbus_message_iter_append_basic(&item, DBUS_TYPE_STRING, &title);
+    dbus_message_iter_append_basic(&item, DBUS_TYPE_INT32, &workspace);
+    dbus_message_iter_append_basic(&item, DBUS_TYPE_INT32, &monitor);
+    dbus_message_iter_append_basic(&item, DBUS_TYPE_UINT32, &flags);
+    dbus_message_iter_close_container(array_iter, &item);
+}
+static void SendSnapshotReply(GooeyShellState *state, DBusMessage *reply)
+{
+    dbus_connection_send(state->dbus_connection, reply, NULL);
+    dbus_connection_flush(state->dbus_connection);
+    dbus_message_unref(reply);
+}
+void HandleWindowSnapshotCommand(GooeyShellState *state, DBusMessage *msg)
+{
+    DBusMessage *reply = NULL;
+    DBusMessageIter args;
+    DBusMessageIter array_iter;
+    dbus_uint64_t generation = 0;
+    int i = 0;
+    if ((state == NULL) || (msg == NULL))
+    {
+        return;
+    }
+    reply = dbus_message_new_method_return(msg);
+    if (reply == NULL)
+    {
+        return;
+    }
+    dbus_message_iter_init_append(reply, &args);
+    glps_thread_mutex_lock(&window_list_mutex);
+    generation = state->snapshot_generation;
+    dbus_message_iter_append_basic(&args, DBUS_TYPE_UINT64, &generation);
+    dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, WINDOW_SNAPSHOT_SIGNATURE, &array_iter);
+    for (i = 0; i < state->snapshot_count; i++)
+    {
+        AppendSnapshotEntry(&array_iter, &state->snapshot_entries[i]);
+    }
+    glps_thread_mutex_unlock(&window_list_mutex);
+    dbus_message_iter_close_container(&args, &array_iter);
+    SendSnapshotReply(state, reply);
+}
+void HandleWindowChangesCommand(GooeyShellState *state, DBusMessage *msg)
+{
+    DBusMessage *reply = NULL;
+    DBusMessageIter args;
+    DBusMessageIter array_iter;
+    dbus_uint64_t since = 0;
+    dbus_uint64_t generation = 0;
+    dbus_bool_t full_resync = FALSE;
+    int i = 0;
+    if ((state == NULL) || (msg == NULL))
+    {
+        return;
+    }
+    if (dbus_message_get_args(msg, NULL, DBUS_TYPE_UINT64, &since, DBUS_TYPE_INVALID) == FALSE)
+    {
+        reply = dbus_message_new_error(msg, DBUS_ERROR_INVALID_ARGS, "Expected a uint64 generation");
+        if (reply != NULL)
+        {
+            SendSnapshotReply(state, reply);
+        }
+        return;
+    }
+    reply = dbus_message_new_method_return(msg);
+    if (reply == NULL)
+    {
+        return;
+    }
+    dbus_message_iter_init_append(reply, &args);
+    glps_thread_mutex_lock(&window_list_mutex);
+    generation = state->snapshot_generation;
+    full_resync = ((since < state->snapshot_history_start) || (since > generation)) ? TRUE : FALSE;
+    dbus_message_iter_append_basic(&args, DBUS_TYPE_UINT64, &generation);
+    dbus_message_iter_append_basic(&args, DBUS_TYPE_BOOLEAN, &full_resync);
+    dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, WINDOW_SNAPSHOT_SIGNATURE, &array_iter);
+    for (i = 0; i < state->snapshot_count; i++)
+    {
+        if ((full_resync != FALSE) || (state->snapshot_entries[i].generation > since))
+        {
+            AppendSnapshotEntry(&array_iter, &state->snapshot_entries[i]);
+        }
+    }
+    dbus_message_iter_close_container(&args, &array_iter);
+    dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, DBUS_TYPE_UINT64_AS_STRING, &array_iter);
+    for (i = 0; (full_resync == FALSE) && (i < state->snapshot_removal_count); i++)
+    {
+        const WindowSnapshotRemoval *removal = &state->snapshot_removals[i];
+        if ((removal->generation > since) && (SnapshotContainsNewer(state, removal->id, removal->generation) == 0))
+        {
+            dbus_uint64_t id = removal->id;
+            dbus_message_iter_append_basic(&array_iter, DBUS_TYPE_UINT64, &id);
+        }
+    }
+    glps_thread_mutex_unlock(&window_list_mutex);
+    dbus_message_iter_close_container(&args, &array_iter);
+    SendSnapshotReply(state, reply);
+}
@@ -0,0 +1,8 @@
+#ifndef GOOEY_SHELL_SNAPSHOT_H
+#define GOOEY_SHELL_SNAPSHOT_H
+#include "gooey_shell.h"
+void PublishWindowSnapshot(GooeyShellState *state);
+void FreeWindowSnapshot(GooeyShellState *state);
+void HandleWindowSnapshotCommand(GooeyShellState *state, DBusMessage *msg);
+void HandleWindowChangesCommand(GooeyShellState *state, DBusMessage *msg);
+#endif
@@ -0,0 +1,304 @@
+#define _GNU_SOURCE
+#include "gooey_shell.h"
+#include "gooey_shell_spawn.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+#define MAX_SPAWN_ARGS 64
+#define SHELL_METACHARACTERS "|&;<>()$`\\\"'*?[]#~=%{}!\n"
+extern char **environ;
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 34)))
+#define HAVE_SPAWN_CLOSEFROM 1
+#else
+#include <linux/close_range.h>
+#endif
+static int OpenPidFd(pid_t pid)
+{
+#ifdef SYS_pidfd_open
+    return (int)syscall(SYS_pidfd_open, pid, 0);
+#else
+    (void)pid;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+#ifndef HAVE_SPAWN_CLOSEFROM
+static void MarkInheritedFdsCloseOnExec(void)
+{
+#ifdef SYS_close_range
+    (void)syscall(SYS_close_range, 3U, ~0U, CLOSE_RANGE_CLOEXEC);
+#endif
+}
+#endif
+void InitializeSpawner(GooeyShellState *state)
+{
+    int i = 0;
+    if (state == NULL)
+    {
+        return;
+    }
+    for (i = 0; i < MAX_SHELL_CHILDREN; i++)
+    {
+        state->children[i].pid = 0;
+        state->children[i].pidfd = -1;
+        state->children[i].on_exit = NULL;
+        state->children[i].data = NULL;
+    }
+    state->untracked_children = 0;
+}
+static void CompleteChild(GooeyShellState *state, ShellChild *child, int status)
+{
+    ShellChildCallback on_exit = child->on_exit;
+    void *data = child->data;
+    pid_t pid = child->pid;
+    if (child->pidfd >= 0)
+    {
+        UnwatchFd(state, child->pidfd);
+        (void)close(child->pidfd);
+    }
+    child->pid = 0;
+    child->pidfd = -1;
+    child->on_exit = NULL;
+    child->data = NULL;
+    if (on_exit != NULL)
+    {
+        on_exit(state, pid, status, data);
+    }
+}
+static ShellChild *FindChild(GooeyShellState *state, pid_t pid)
+{
+    int i = 0;
+    for (i = 0; i < MAX_SHELL_CHILDREN; i++)
+    {
+        if (state->children[i].pid == pid)
+        {
+            return &state->children[i];
+        }
+    }
+    return NULL;
+}
+static void HandlePidFd(GooeyShellState *state, int fd, unsigned int events, void *data)
+{
+    ShellChild *child = (ShellChild *)data;
+    int status = 0;
+    pid_t result = 0;
+    (void)fd;
+    (void)events;
+    if ((child == NULL) || (child->pid <= 0))
+    {
+        return;
+    }
+    result = waitpid(child->pid, &status, WNOHANG);
+    if (result == child->pid)
+    {
+        CompleteChild(state, child, status);
+    }
+    else if ((result < 0) && (errno == ECHILD))
+    {
+        CompleteChild(state, child, 0);
+    }
+}
+void ReapChildProcesses(GooeyShellState *state)
+{
+    int status = 0;
+    pid_t pid = 0;
+    int i = 0;
+    if (state == NULL)
+    {
+        return;
+    }
+    if (state->untracked_children > 0)
+    {
+        while ((pid = waitpid(-1, &status, WNOHANG)) > 0)
+        {
+            ShellChild *child = FindChild(state, pid);
+            if (child != NULL)
+            {
+                CompleteChild(state, child, status);
+            }
+            else if (state->untracked_children > 0)
+            {
+                state->untracked_children--;
+            }
+        }
+        return;
+    }
+    for (i = 0; i < MAX_SHELL_CHILDREN; i++)
+    {
+        ShellChild *child = &state->children[i];
+        if ((child->pid > 0) && (child->pidfd < 0) && (waitpid(child->pid, &status, WNOHANG) == child->pid))
+        {
+            CompleteChild(state, child, status);
+        }
+    }
+}
+static void TrackChild(GooeyShellState *state, pid_t pid, ShellChildCallback on_exit, void *data)
+{
+    ShellChild *child = FindChild(state, 0);
+    if (child == NULL)
+    {
+        LogError("TrackChild: Child table full, PID %d will be reaped on SIGCHLD", pid);
+        state->untracked_children++;
+        return;
+    }
+    child->pid = pid;
+    child->on_exit = on_exit;
+    child->data = data;
+    child->pidfd = OpenPidFd(pid);
+    if ((child->pidfd >= 0) && (WatchFd(state, child->pidfd, EPOLLIN, HandlePidFd, child) != 0))
+    {
+        (void)close(child->pidfd);
+        child->pidfd = -1;
+    }
+}
+static int NeedsShell(const char *command)
+{
+    return (strpbrk(command, SHELL_METACHARACTERS) != NULL) ? 1 : 0;
+}
+static int SplitCommand(char *buffer, char **argv, int max_args)
+{
+    int argc = 0;
+    char *saveptr = NULL;
+    char *token = strtok_r(buffer, " \t", &saveptr);
+    while ((token != NULL) && (argc < max_args - 1))
+    {
+        argv[argc++] = token;
+        token = strtok_r(NULL, " \t", &saveptr);
+    }
+    argv[argc] = NULL;
+    return (token == NULL) ? argc : -1;
+}
+static int EnvKeyMatches(const char *entry, const char *assignment)
+{
+    const char *eq = strchr(assignment, '=');
+    size_t key_len = (eq != NULL) ? (size_t)(eq - assignment) : strlen(assignment);
+    return ((strncmp(entry, assignment, key_len) == 0) && (entry[key_len] == '=')) ? 1 : 0;
+}
+static char **BuildEnvironment(const char *const *env)
+{
+    char **envp = NULL;
+    size_t base_count = 0;
+    size_t extra_count = 0;
+    size_t count = 0;
+    size_t i = 0;
+    size_t j = 0;
+    while (environ[base_count] != NULL)
+    {
+        base_count++;
+    }
+    while ((env != NULL) && (env[extra_count] != NULL))
+    {
+        extra_count++;
+    }
+    envp = malloc(sizeof(char *) * (base_count + extra_count + 1));
+    if (envp == NULL)
+    {
+        return NULL;
+    }
+    for (i = 0; i < base_count; i++)
+    {
+        int overridden = 0;
+        for (j = 0; j < extra_count; j++)
+        {
+            if (EnvKeyMatches(environ[i], env[j]) != 0)
+            {
+                overridden = 1;
+                break;
+            }
+        }
+        if (overridden == 0)
+        {
+            envp[count++] = environ[i];
+        }
+    }
+    for (j = 0; j < extra_count; j++)
+    {
+        envp[count++] = (char *)env[j];
+    }
+    envp[count] = NULL;
+    return envp;
+}
+pid_t SpawnProcess(GooeyShellState *state, const char *command, const char *const *env, ShellChildCallback on_exit,
+                   void *data)
+{
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    sigset_t empty_mask;
+    char *argv[MAX_SPAWN_ARGS];
+    char *buffer = NULL;
+    char **envp = NULL;
+    pid_t pid = 0;
+    int result = 0;
+    if ((state == NULL) || (command == NULL) || (command[0] == '\0'))
+    {
+        return -1;
+    }
+    buffer = strdup(command);
+    envp = (env != NULL) ? BuildEnvironment(env) : environ;
+    if ((buffer == NULL) || (envp == NULL))
+    {
+        LogError("SpawnProcess: Out of memory preparing %s", command);
+        free(buffer);
+        return -1;
+    }
+    if ((NeedsShell(command) != 0) || (SplitCommand(buffer, argv, MAX_SPAWN_ARGS) <= 0))
+    {
+        argv[0] = "/bin/sh";
+        argv[1] = "-c";
+        argv[2] = (char *)command;
+        argv[3] = NULL;
+    }
+    sigemptyset(&empty_mask);
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setsigmask(&attr, &empty_mask);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK);
+    posix_spawn_file_actions_init(&actions);
+#ifdef HAVE_SPAWN_CLOSEFROM
+    posix_spawn_file_actions_addclosefrom_np(&actions, 3);
+#else
+    MarkInheritedFdsCloseOnExec();
+#endif
+    result = posix_spawnp(&pid, argv[0], &actions, &attr, argv, envp);
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+    if (envp != environ)
+    {
+        free(envp);
+    }
+    free(buffer);
+    if (result != 0)
+    {
+        LogError("SpawnProcess: Failed to spawn %s: %s", command, strerror(result));
+        return -1;
+    }
+    TrackChild(state, pid, on_exit, data);
+    return pid;
+}
+void CleanupSpawner(GooeyShellState *state)
+{
+    int i = 0;
+    if (state == NULL)
+    {
+        return;
+    }
+    for (i = 0; i < MAX_SHELL_CHILDREN; i++)
+    {
+        ShellChild *child = &state->children[i];
+        if ((child->pid > 0) && (child->pidfd >= 0))
+        {
+            UnwatchFd(state, child->pidfd);
+            (void)close(child->pidfd);
+        }
+        child->pid = 0;
+        child->pidfd = -1;
+        child->on_exit = NULL;
+        child->data = NULL;
+    }
+}
@@ -0,0 +1,9 @@
+#ifndef GOOEY_SHELL_SPAWN_H
+#define GOOEY_SHELL_SPAWN_H
+#include "gooey_shell.h"
+void InitializeSpawner(GooeyShellState *state);
+void CleanupSpawner(GooeyShellState *state);
+pid_t SpawnProcess(GooeyShellState *state, const char *command, const char *const *env, ShellChildCallback on_exit,
+                   void *data);
+void ReapChildProcesses(GooeyShellState *state);
+#endif
@@ -0,0 +1,156 @@
+#include "gooey_shell.h"
+#include "gooey_shell_stack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+StackLayer GetWindowStackLayer(const WindowNode *node)
+{
+    if (node->is_desktop_app != 0)
+    {
+        return STACK_LAYER_DESKTOP;
+    }
+    if (node->is_fullscreen_app != 0)
+    {
+        return (node->stay_on_top != 0) ? STACK_LAYER_FULLSCREEN_APP : STACK_LAYER_ABOVE;
+    }
+    if (node->stay_on_top != 0)
+    {
+        return STACK_LAYER_ABOVE;
+    }
+    return (node->is_floating != 0) ? STACK_LAYER_FLOATING : STACK_LAYER_NORMAL;
+}
+void RaiseWindowNode(GooeyShellState *state, WindowNode *node)
+{
+    if ((state == NULL) || (node == NULL))
+    {
+        return;
+    }
+    state->stack_seq_top++;
+    node->stack_seq = state->stack_seq_top;
+}
+void LowerWindowNode(GooeyShellState *state, WindowNode *node)
+{
+    if ((state == NULL) || (node == NULL))
+    {
+        return;
+    }
+    state->stack_seq_bottom--;
+    node->stack_seq = state->stack_seq_bottom;
+}
+static int CompareStackEntries(const void *a, const void *b)
+{
+    const StackEntry *lhs = (const StackEntry *)a;
+    const StackEntry *rhs = (const StackEntry *)b;
+    if (lhs->layer != rhs->layer)
+    {
+        return (lhs->layer > rhs->layer) ? -1 : 1;
+    }
+    if (lhs->seq != rhs->seq)
+    {
+        return (lhs->seq > rhs->seq) ? -1 : 1;
+    }
+    return 0;
+}
+static int ReserveStackBuffers(GooeyShellState *state, int count)
+{
+    StackEntry *entries = NULL;
+    Window *desired = NULL;
+    Window *committed = NULL;
+    int capacity = 0;
+    if (count <= state->stack_capacity)
+    {
+        return 1;
+    }
+    capacity = (state->stack_capacity > 0) ? state->stack_capacity : 16;
+    while (capacity < count)
+    {
+        capacity *= 2;
+    }
+    entries = realloc(state->stack_entries, sizeof(StackEntry) * (size_t)capacity);
+    if (entries == NULL)
+    {
+        LogError("ReserveStackBuffers: Failed to allocate stack entries");
+        return 0;
+    }
+    state->stack_entries = entries;
+    desired = realloc(state->desired_stack, sizeof(Window) * (size_t)capacity);
+    if (desired == NULL)
+    {
+        LogError("ReserveStackBuffers: Failed to allocate desired stack");
+        return 0;
+    }
+    state->desired_stack = desired;
+    committed = realloc(state->committed_stack, sizeof(Window) * (size_t)capacity);
+    if (committed == NULL)
+    {
+        LogError("ReserveStackBuffers: Failed to allocate committed stack");
+        return 0;
+    }
+    state->committed_stack = committed;
+    state->stack_capacity = capacity;
+    return 1;
+}
+int CommitStacking(GooeyShellState *state)
+{
+    StackEntry *entries = NULL;
+    Window *swap = NULL;
+    int count = 0;
+    int i = 0;
+    if (ValidateWindowState(state) == 0)
+    {
+        return 0;
+    }
+    if (ReserveStackBuffers(state, state->window_index_count) == 0)
+    {
+        return 0;
+    }
+    entries = state->stack_entries;
+    for (i = 0; i < state->window_index_capacity; i++)
+    {
+        WindowIndexEntry *slot = &state->window_index[i];
+        if ((slot->node != NULL) && (slot->key == slot->node->frame) && (slot->key != None))
+        {
+            entries[count].frame = slot->node->frame;
+            entries[count].layer = GetWindowStackLayer(slot->node);
+            entries[count].seq = slot->node->stack_seq;
+            count++;
+        }
+    }
+    if (count > 1)
+    {
+        qsort(entries, (size_t)count, sizeof(StackEntry), CompareStackEntries);
+    }
+    for (i = 0; i < count; i++)
+    {
+        state->desired_stack[i] = entries[i].frame;
+    }
+    if ((count == state->committed_stack_count) &&
+        ((count == 0) || (memcmp(state->desired_stack, state->committed_stack, sizeof(Window) * (size_t)count) == 0)))
+    {
+        return 0;
+    }
+    if (count > 1)
+    {
+        XRestackWindows(state->display, state->desired_stack, count);
+    }
+    swap = state->committed_stack;
+    state->committed_stack = state->desired_stack;
+    state->desired_stack = swap;
+    state->committed_stack_count = count;
+    return 1;
+}
+void FreeStacking(GooeyShellState *state)
+{
+    if (state == NULL)
+    {
+        return;
+    }
+    free(state->stack_entries);
+    free(state->desired_stack);
+    free(state->committed_stack);
+    state->stack_entries = NULL;
+    state->desired_stack = NULL;
+    state->committed_stack = NULL;
+    state->stack_capacity = 0;
+    state->committed_stack_count = 0;
+}
@@ -0,0 +1,9 @@
+#ifndef GOOEY_SHELL_STACK_H
+#define GOOEY_SHELL_STACK_H
+#include "gooey_shell.h"
+StackLayer GetWindowStackLayer(const WindowNode *node);
+void RaiseWindowNode(GooeyShellState *state, WindowNode *node);
+void LowerWindowNode(GooeyShellState *state, WindowNode *node);
+int CommitStacking(GooeyShellState *state);
+void FreeStacking(GooeyShellState *state);
+#endif
@@ -0,0 +1,299 @@
+#include "gooey_shell.h"
+#include "gooey_shell_stats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+static const char *const event_names[LASTEvent] = {
+    [KeyPress] = "KeyPress",
+    [KeyRelease] = "KeyRelease",
+    [ButtonPress] = "ButtonPress",
+    [ButtonRelease] = "ButtonRelease",
+    [MotionNotify] = "MotionNotify",
+    [EnterNotify] = "EnterNotify",
+    [LeaveNotify] = "LeaveNotify",
+    [FocusIn] = "FocusIn",
+    [FocusOut] = "FocusOut",
+    [KeymapNotify] = "KeymapNotify",
+    [Expose] = "Expose",
+    [GraphicsExpose] = "GraphicsExpose",
+    [NoExpose] = "NoExpose",
+    [VisibilityNotify] = "VisibilityNotify",
+    [CreateNotify] = "CreateNotify",
+    [DestroyNotify] = "DestroyNotify",
+    [UnmapNotify] = "UnmapNotify",
+    [MapNotify] = "MapNotify",
+    [MapRequest] = "MapRequest",
+    [ReparentNotify] = "ReparentNotify",
+    [ConfigureNotify] = "ConfigureNotify",
+    [ConfigureRequest] = "ConfigureRequest",
+    [GravityNotify] = "GravityNotify",
+    [ResizeRequest] = "ResizeRequest",
+    [CirculateNotify] = "CirculateNotify",
+    [CirculateRequest] = "CirculateRequest",
+    [PropertyNotify] = "PropertyNotify",
+    [SelectionClear] = "SelectionClear",
+    [SelectionRequest] = "SelectionRequest",
+    [SelectionNotify] = "SelectionNotify",
+    [ColormapNotify] = "ColormapNotify",
+    [ClientMessage] = "ClientMessage",
+    [MappingNotify] = "MappingNotify",
+    [GenericEvent] = "GenericEvent",
+};
+static const char *const command_names[SHELL_COMMAND_COUNT] = {
+    [SHELL_COMMAND_MINIMIZE] = "minimize",
+    [SHELL_COMMAND_RESTORE] = "restore",
+    [SHELL_COMMAND_CLOSE] = "close",
+    [SHELL_COMMAND_TOGGLE_TILING] = "toggle_tiling",
+    [SHELL_COMMAND_FOCUS_NEXT] = "focus_next",
+    [SHELL_COMMAND_FOCUS_PREVIOUS] = "focus_previous",
+    [SHELL_COMMAND_SET_WALLPAPER] = "set_wallpaper",
+    [SHELL_COMMAND_RESET_STATS] = "reset_stats",
+    [SHELL_COMMAND_DUMP_TRACE] = "dump_trace",
+};
+const char *GetXEventName(int event_type)
+{
+    if ((event_type >= 0) && (event_type < LASTEvent) && (event_names[event_type] != NULL))
+    {
+        return event_names[event_type];
+    }
+    return "Extension";
+}
+static int GetLatencyBucket(unsigned long long value)
+{
+    int magnitude = 0;
+    int bucket = 0;
+    if (value < STATS_SUB_BUCKETS)
+    {
+        return (int)value;
+    }
+    magnitude = 63 - __builtin_clzll(value);
+    bucket = (magnitude - STATS_SUB_BUCKET_BITS + 1) * STATS_SUB_BUCKETS +
+             (int)((value >> (magnitude - STATS_SUB_BUCKET_BITS)) & (STATS_SUB_BUCKETS - 1));
+    return (bucket < STATS_BUCKETS) ? bucket : STATS_BUCKETS - 1;
+}
+static unsigned long long GetLatencyBucketValue(int bucket)
+{
+    int magnitude = 0;
+    unsigned long long sub = 0ULL;
+    if (bucket < STATS_SUB_BUCKETS)
+    {
+        return (unsigned long long)bucket;
+    }
+    magnitude = bucket / STATS_SUB_BUCKETS + STATS_SUB_BUCKET_BITS - 1;
+    sub = (unsigned long long)(bucket % STATS_SUB_BUCKETS);
+    return ((STATS_SUB_BUCKETS | sub) << (magnitude - STATS_SUB_BUCKET_BITS)) +
+           ((1ULL << (magnitude - STATS_SUB_BUCKET_BITS)) - 1ULL);
+}
+void RecordLatency(LatencyHistogram *histogram, unsigned long long elapsed_ns, unsigned long requests)
+{
+    unsigned long max_ns = atomic_load_explicit(&histogram->max_ns, memory_order_relaxed);
+    atomic_fetch_add_explicit(&histogram->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&histogram->sum_ns, (unsigned long)elapsed_ns, memory_order_relaxed);
+    atomic_fetch_add_explicit(&histogram->requests, requests, memory_order_relaxed);
+    atomic_fetch_add_explicit(&histogram->buckets[GetLatencyBucket(elapsed_ns)], 1, memory_order_relaxed);
+    if (elapsed_ns > max_ns)
+    {
+        atomic_store_explicit(&histogram->max_ns, (unsigned long)elapsed_ns, memory_order_relaxed);
+    }
+}
+void RecordEventStats(GooeyShellState *state, int event_type, unsigned long long elapsed_ns, unsigned long requests)
+{
+    int index = ((event_type >= 0) && (event_type < LASTEvent)) ? event_type : LASTEvent;
+    RecordLatency(&state->event_stats[index], elapsed_ns, requests);
+}
+void RecordCommandStats(GooeyShellState *state, ShellCommandType type, unsigned long long elapsed_ns,
+                        unsigned long requests)
+{
+    if ((type >= 0) && (type < SHELL_COMMAND_COUNT))
+    {
+        RecordLatency(&state->command_stats[type], elapsed_ns, requests);
+    }
+}
+void RecordDBusStats(GooeyShellState *state, const char *method, unsigned long long elapsed_ns)
+{
+    int i = 0;
+    if (method == NULL)
+    {
+        return;
+    }
+    for (i = 0; i < state->dbus_stat_count; i++)
+    {
+        if (strcmp(state->dbus_stat_names[i], method) == 0)
+        {
+            break;
+        }
+    }
+    if (i == state->dbus_stat_count)
+    {
+        if (state->dbus_stat_count == MAX_DBUS_STAT_METHODS)
+        {
+            return;
+        }
+        state->dbus_stat_names[i] = StrDup(method);
+        if (state->dbus_stat_names[i] == NULL)
+        {
+            return;
+        }
+        state->dbus_stat_count++;
+    }
+    RecordLatency(&state->dbus_stats[i], elapsed_ns, 0);
+}
+static void ResetHistogram(LatencyHistogram *histogram)
+{
+    int i = 0;
+    atomic_store_explicit(&histogram->count, 0, memory_order_relaxed);
+    atomic_store_explicit(&histogram->sum_ns, 0, memory_order_relaxed);
+    atomic_store_explicit(&histogram->max_ns, 0, memory_order_relaxed);
+    atomic_store_explicit(&histogram->requests, 0, memory_order_relaxed);
+    for (i = 0; i < STATS_BUCKETS; i++)
+    {
+        atomic_store_explicit(&histogram->buckets[i], 0, memory_order_relaxed);
+    }
+}
+void ResetShellStats(GooeyShellState *state)
+{
+    int i = 0;
+    for (i = 0; i <= LASTEvent; i++)
+    {
+        ResetHistogram(&state->event_stats[i]);
+    }
+    for (i = 0; i < SHELL_COMMAND_COUNT; i++)
+    {
+        ResetHistogram(&state->command_stats[i]);
+    }
+    for (i = 0; i < LAYOUT_COUNT; i++)
+    {
+        ResetHistogram(&state->layout_stats[i]);
+    }
+}
+void ResetDBusStats(GooeyShellState *state)
+{
+    int i = 0;
+    for (i = 0; i < state->dbus_stat_count; i++)
+    {
+        ResetHistogram(&state->dbus_stats[i]);
+    }
+}
+void FreeShellStats(GooeyShellState *state)
+{
+    int i = 0;
+    for (i = 0; i < state->dbus_stat_count; i++)
+    {
+        SAFE_FREE(state->dbus_stat_names[i]);
+    }
+    state->dbus_stat_count = 0;
+}
+static unsigned long long GetPercentile(const unsigned long *buckets, unsigned long count, unsigned long long max_ns,
+                                        int percentile)
+{
+    unsigned long threshold =
+        (unsigned long)(((unsigned long long)count * (unsigned long long)percentile + 99ULL) / 100ULL);
+    unsigned long seen = 0;
+    int i = 0;
+    for (i = 0; i < STATS_BUCKETS; i++)
+    {
+        seen += buckets[i];
+        if ((seen >= threshold) && (seen != 0))
+        {
+            unsigned long long value = GetLatencyBucketValue(i);
+            return (value < max_ns) ? value : max_ns;
+        }
+    }
+    return max_ns;
+}
+static void AppendHistogram(DBusMessageIter *array_iter, const char *category, const char *name,
+                            LatencyHistogram *histogram)
+{
+    DBusMessageIter entry;
+    unsigned long buckets[STATS_BUCKETS];
+    dbus_uint64_t count = atomic_load_explicit(&histogram->count, memory_order_relaxed);
+    dbus_uint64_t sum_ns = atomic_load_explicit(&histogram->sum_ns, memory_order_relaxed);
+    dbus_uint64_t max_ns = atomic_load_explicit(&histogram->max_ns, memory_order_relaxed);
+    dbus_uint64_t requests = atomic_load_explicit(&histogram->requests, memory_order_relaxed);
+    dbus_uint64_t mean_ns = 0;
+    dbus_uint64_t p50_ns = 0;
+    dbus_uint64_t p99_ns = 0;
+    int i = 0;
+    if (count == 0)
+    {
+        return;
+    }
+    for (i = 0; i < STATS_BUCKETS; i++)
+    {
+        buckets[i] = atomic_load_explicit(&histogram->buckets[i], memory_order_relaxed);
+    }
+    mean_ns = sum_ns / count;
+    p50_ns = GetPercentile(buckets, (unsigned long)count, max_ns, 50);
+    p99_ns = GetPercentile(buckets, (unsigned long)count, max_ns, 99);
+    dbus_message_iter_open_container(array_iter, DBUS_TYPE_STRUCT, NULL, &entry);
+    dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &category);
+    dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &name);
+    dbus_message_iter_append_basic(&entry, DBUS_TYPE_UINT64, &count);
+    dbus_message_iter_append_basic(&entry, DBUS_TYPE_UINT64, &mean_ns);
+    dbus_message_iter_append_basic(&entry, DBUS_TYPE_UINT64, &p50_ns);
+    dbus_message_iter_append_basic(&entry, DBUS_TYPE_UINT64, &p99_ns);
+    dbus_message_iter_append_basic(&entry, DBUS_TYPE_UINT64, &max_ns);
+    dbus_message_iter_append_basic(&entry, DBUS_TYPE_UINT64, &requests);
+    dbus_message_iter_close_container(array_iter, &entry);
+}
+void HandleGetStatsCommand(GooeyShellState *state, DBusMessage *msg)
+{
+    DBusMessage *reply = NULL;
+    DBusMessageIter args;
+    DBusMessageIter array_iter;
+    int i = 0;
+    if ((state == NULL) || (msg == NULL))
+    {
+        return;
+    }
+    reply = dbus_message_new_method_return(msg);
+    if (reply == NULL)
+    {
+        return;
+    }
+    dbus_message_iter_init_append(reply, &args);
+    dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, "(sstttttt)", &array_iter);
+    for (i = 0; i <= LASTEvent; i++)
+    {
+        AppendHistogram(&array_iter, "x", GetXEventName(i), &state->event_stats[i]);
+    }
+    for (i = 0; i < SHELL_COMMAND_COUNT; i++)
+    {
+        AppendHistogram(&array_iter, "command", command_names[i], &state->command_stats[i]);
+    }
+    for (i = 0; i < LAYOUT_COUNT; i++)
+    {
+        AppendHistogram(&array_iter, "layout", GetLayoutName((LayoutMode)i), &state->layout_stats[i]);
+    }
+    for (i = 0; i < state->dbus_stat_count; i++)
+    {
+        AppendHistogram(&array_iter, "dbus", state->dbus_stat_names[i], &state->dbus_stats[i]);
+    }
+    dbus_message_iter_close_container(&args, &array_iter);
+    dbus_connection_send(state->dbus_connection, reply, NULL);
+    dbus_connection_flush(state->dbus_connection);
+    dbus_message_unref(reply);
+}
+void HandleResetStatsCommand(GooeyShellState *state, DBusMessage *msg)
+{
+    DBusMessage *reply = NULL;
+    if ((state == NULL) || (msg == NULL))
+    {
+        return;
+    }
+    ResetDBusStats(state);
+    if (EnqueueShellCommand(state, SHELL_COMMAND_RESET_STATS, None, NULL) != 0)
+    {
+        reply = dbus_message_new_error(msg, SHELL_ERROR_QUEUE_FULL, "Shell command queue is full");
+    }
+    else
+    {
+        reply = dbus_message_new_method_return(msg);
+    }
+    if (reply != NULL)
+    {
+        dbus_connection_send(state->dbus_connection, reply, NULL);
+        dbus_connection_flush(state->dbus_connection);
+        dbus_message_unref(reply);
+    }
+}
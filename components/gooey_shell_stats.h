@@ -0,0 +1,15 @@
+#ifndef GOOEY_SHELL_STATS_H
+#define GOOEY_SHELL_STATS_H
+#include "gooey_shell.h"
+const char *GetXEventName(int event_type);
+void RecordLatency(LatencyHistogram *histogram, unsigned long long elapsed_ns, unsigned long requests);
+void RecordEventStats(GooeyShellState *state, int event_type, unsigned long long elapsed_ns, unsigned long requests);
+void RecordCommandStats(GooeyShellState *state, ShellCommandType type, unsigned long long elapsed_ns,
+                        unsigned long requests);
+void RecordDBusStats(GooeyShellState *state, const char *method, unsigned long long elapsed_ns);
+void ResetShellStats(GooeyShellState *state);
+void ResetDBusStats(GooeyShellState *state);
+void FreeShellStats(GooeyShellState *state);
+void HandleGetStatsCommand(GooeyShellState *state, DBusMessage *msg);
+void HandleResetStatsCommand(GooeyShellState *state, DBusMessage *msg);
+#endif
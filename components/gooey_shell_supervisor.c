@@ -0,0 +1,296 @@
+#include "gooey_shell.h"
+#include "gooey_shell_supervisor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <signal.h>
+#include <sys/wait.h>
+#define DESKTOP_RESTART_MIN_MS 50
+#define DESKTOP_RESTART_MAX_MS 30000
+#define DESKTOP_STABLE_RUN_NS 30000000000ULL
+static void StartSupervisedDesktopApp(GooeyShellState *state, int index);
+static void ResetSupervisedProcess(SupervisedProcess *proc, int monitor_number)
+{
+    memset(proc, 0, sizeof(*proc));
+    proc->monitor_number = monitor_number;
+    proc->window = None;
+    proc->restart_timer = -1;
+    proc->backoff_ms = DESKTOP_RESTART_MIN_MS;
+}
+static int EncodeExitStatus(int status)
+{
+    if (WIFEXITED(status))
+    {
+        return WEXITSTATUS(status);
+    }
+    if (WIFSIGNALED(status))
+    {
+        return -WTERMSIG(status);
+    }
+    return 0;
+}
+static void RestartDesktopAppTimer(GooeyShellState *state, void *data)
+{
+    int index = (int)(intptr_t)data;
+    if ((index < 0) || (index >= state->desktop_app_count))
+    {
+        return;
+    }
+    state->desktop_apps[index].restart_timer = -1;
+    if (state->desktop_apps[index].pid == 0)
+    {
+        StartSupervisedDesktopApp(state, index);
+    }
+}
+static void ScheduleDesktopAppRestart(GooeyShellState *state, int index)
+{
+    SupervisedProcess *proc = &state->desktop_apps[index];
+    int delay_ms = 0;
+    if ((proc->started_ns != 0ULL) && (GetMonotonicTimeNs() - proc->started_ns >= DESKTOP_STABLE_RUN_NS))
+    {
+        proc->backoff_ms = DESKTOP_RESTART_MIN_MS;
+    }
+    delay_ms = proc->backoff_ms;
+    proc->backoff_ms = (proc->backoff_ms * 2 > DESKTOP_RESTART_MAX_MS) ? DESKTOP_RESTART_MAX_MS : proc->backoff_ms * 2;
+    if (proc->restart_timer >= 0)
+    {
+        CancelTimer(state, proc->restart_timer);
+    }
+    proc->restart_timer = AddTimer(state, delay_ms, RestartDesktopAppTimer, (void *)(intptr_t)index);
+    LogInfo("ScheduleDesktopAppRestart: Restarting desktop app for monitor %d in %d ms", proc->monitor_number,
+            delay_ms);
+}
+static void DesktopAppExited(GooeyShellState *state, pid_t pid, int status, void *data)
+{
+    int index = 0;
+    (void)data;
+    for (index = 0; index < state->desktop_app_count; index++)
+    {
+        if (state->desktop_apps[index].pid == pid)
+        {
+            break;
+        }
+    }
+    if (index == state->desktop_app_count)
+    {
+        return;
+    }
+    glps_thread_mutex_lock(&window_list_mutex);
+    state->desktop_apps[index].pid = 0;
+    state->desktop_apps[index].last_exit_status = EncodeExitStatus(status);
+    state->desktop_apps[index].restart_count++;
+    glps_thread_mutex_unlock(&window_list_mutex);
+    LogError("DesktopAppExited: Desktop app for monitor %d (PID: %d) exited with status %d",
+             state->desktop_apps[index].monitor_number, pid, state->desktop_apps[index].last_exit_status);
+    ScheduleDesktopAppRestart(state, index);
+}
+pid_t LaunchDesktopAppForMonitor(GooeyShellState *state, int monitor_number)
+{
+    char display_env[256];
+    char monitor_env[32];
+    const char *env[] = {"GOOEY_DESKTOP_APP=1", display_env, monitor_env, NULL};
+    pid_t pid = 0;
+    (void)snprintf(display_env, sizeof(display_env), "DISPLAY=%s", DisplayString(state->display));
+    (void)snprintf(monitor_env, sizeof(monitor_env), "GOOEY_MONITOR=%d", monitor_number);
+    pid = SpawnProcess(state, "/usr/local/bin/gooeyde_desktop", env, DesktopAppExited, NULL);
+    if (pid > 0)
+    {
+        LogInfo("LaunchDesktopAppForMonitor: Launched desktop app for monitor %d (PID: %d)", monitor_number, pid);
+    }
+    else
+    {
+        LogError("LaunchDesktopAppForMonitor: Failed to spawn desktop app on monitor %d", monitor_number);
+    }
+    return pid;
+}
+static void StartSupervisedDesktopApp(GooeyShellState *state, int index)
+{
+    SupervisedProcess *proc = &state->desktop_apps[index];
+    pid_t pid = LaunchDesktopAppForMonitor(state, proc->monitor_number);
+    glps_thread_mutex_lock(&window_list_mutex);
+    proc->pid = (pid > 0) ? pid : 0;
+    proc->started_ns = GetMonotonicTimeNs();
+    glps_thread_mutex_unlock(&window_list_mutex);
+    if (pid <= 0)
+    {
+        ScheduleDesktopAppRestart(state, index);
+    }
+}
+void SyncDesktopApps(GooeyShellState *state, const int *new_to_old, int new_count)
+{
+    SupervisedProcess *procs = NULL;
+    SupervisedProcess *old_procs = NULL;
+    int old_count = 0;
+    int i = 0;
+    if (state == NULL)
+    {
+        return;
+    }
+    procs = calloc((size_t)((new_count > 0) ? new_count : 1), sizeof(SupervisedProcess));
+    if (procs == NULL)
+    {
+        LogError("SyncDesktopApps: Failed to allocate desktop app table");
+        return;
+    }
+    old_procs = state->desktop_apps;
+    old_count = state->desktop_app_count;
+    for (i = 0; i < new_count; i++)
+    {
+        int old_index = (new_to_old != NULL) ? new_to_old[i] : -1;
+        if ((old_index == i) && (old_index < old_count))
+        {
+            procs[i] = old_procs[old_index];
+            old_procs[old_index].pid = 0;
+            old_procs[old_index].restart_timer = -1;
+        }
+        else
+        {
+            ResetSupervisedProcess(&procs[i], i);
+        }
+    }
+    for (i = 0; i < old_count; i++)
+    {
+        if (old_procs[i].restart_timer >= 0)
+        {
+            CancelTimer(state, old_procs[i].restart_timer);
+            old_procs[i].restart_timer = -1;
+        }
+        if (old_procs[i].pid > 0)
+        {
+            LogInfo("SyncDesktopApps: Stopping desktop app for monitor %d (PID: %d)", i, old_procs[i].pid);
+            (void)kill(old_procs[i].pid, SIGTERM);
+        }
+    }
+    glps_thread_mutex_lock(&window_list_mutex);
+    state->desktop_apps = procs;
+    state->desktop_app_count = new_count;
+    glps_thread_mutex_unlock(&window_list_mutex);
+    free(old_procs);
+    for (i = 0; i < new_count; i++)
+    {
+        if ((procs[i].pid != 0) || (procs[i].restart_timer >= 0))
+        {
+            continue;
+        }
+        if (procs[i].started_ns != 0ULL)
+        {
+            ScheduleDesktopAppRestart(state, i);
+        }
+        else
+        {
+            StartSupervisedDesktopApp(state, i);
+        }
+    }
+}
+void LaunchDesktopAppsForAllMonitors(GooeyShellState *state)
+{
+    if ((state == NULL) || (state->monitor_info.monitors == NULL) || (state->monitor_info.num_monitors == 0))
+    {
+        return;
+    }
+    LogInfo("LaunchDesktopAppsForAllMonitors: Launching desktop apps for %d monitors",
+            state->monitor_info.num_monitors);
+    SyncDesktopApps(state, NULL, state->monitor_info.num_monitors);
+}
+void StopDesktopApps(GooeyShellState *state)
+{
+    int i = 0;
+    if (state == NULL)
+    {
+        return;
+    }
+    for (i = 0; i < state->desktop_app_count; i++)
+    {
+        if (state->desktop_apps[i].restart_timer >= 0)
+        {
+            CancelTimer(state, state->desktop_apps[i].restart_timer);
+        }
+    }
+    glps_thread_mutex_lock(&window_list_mutex);
+    SAFE_FREE(state->desktop_apps);
+    state->desktop_app_count = 0;
+    glps_thread_mutex_unlock(&window_list_mutex);
+}
+void AdoptDesktopAppWindow(GooeyShellState *state, WindowNode *node)
+{
+    SupervisedProcess *target = NULL;
+    int i = 0;
+    if ((state == NULL) || (node == NULL))
+    {
+        return;
+    }
+    for (i = 0; i < state->desktop_app_count; i++)
+    {
+        SupervisedProcess *proc = &state->desktop_apps[i];
+        if ((proc->window == None) && (proc->pid > 0) &&
+            ((target == NULL) || (proc->monitor_number == node->monitor_number)))
+        {
+            target = proc;
+        }
+    }
+    if (target != NULL)
+    {
+        glps_thread_mutex_lock(&window_list_mutex);
+        target->window = node->frame;
+        glps_thread_mutex_unlock(&window_list_mutex);
+    }
+}
+void ReleaseDesktopAppWindow(GooeyShellState *state, Window frame)
+{
+    int i = 0;
+    if (state == NULL)
+    {
+        return;
+    }
+    for (i = 0; i < state->desktop_app_count; i++)
+    {
+        if (state->desktop_apps[i].window == frame)
+        {
+            glps_thread_mutex_lock(&window_list_mutex);
+            state->desktop_apps[i].window = None;
+            glps_thread_mutex_unlock(&window_list_mutex);
+        }
+    }
+}
+void HandleDesktopAppStatusCommand(GooeyShellState *state, DBusMessage *msg)
+{
+    DBusMessage *reply = NULL;
+    DBusMessageIter args;
+    DBusMessageIter array_iter;
+    int i = 0;
+    if ((state == NULL) || (msg == NULL))
+    {
+        return;
+    }
+    reply = dbus_message_new_method_return(msg);
+    if (reply == NULL)
+    {
+        return;
+    }
+    dbus_message_iter_init_append(reply, &args);
+    dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, "(iiuit)", &array_iter);
+    glps_thread_mutex_lock(&window_list_mutex);
+    for (i = 0; i < state->desktop_app_count; i++)
+    {
+        DBusMessageIter entry;
+        const SupervisedProcess *proc = &state->desktop_apps[i];
+        dbus_int32_t monitor_number = proc->monitor_number;
+        dbus_int32_t pid = proc->pid;
+        dbus_uint32_t restart_count = (dbus_uint32_t)proc->restart_count;
+        dbus_int32_t last_exit_status = proc->last_exit_status;
+        dbus_uint64_t window = (dbus_uint64_t)proc->window;
+        dbus_message_iter_open_container(&array_iter, DBUS_TYPE_STRUCT, NULL, &entry);
+        dbus_message_iter_append_basic(&entry, DBUS_TYPE_INT32, &monitor_number);
+        dbus_message_iter_append_basic(&entry, DBUS_TYPE_INT32, &pid);
+        dbus_message_iter_append_basic(&entry, DBUS_TYPE_UINT32, &restart_count);
+        dbus_message_iter_append_basic(&entry, DBUS_TYPE_INT32, &last_exit_status);
+        dbus_message_iter_append_basic(&entry, DBUS_TYPE_UINT64, &window);
+        dbus_message_iter_close_container(&array_iter, &entry);
+    }
+    glps_thread_mutex_unlock(&window_list_mutex);
+    dbus_message_iter_close_container(&args, &array_iter);
+    dbus_connection_send(state->dbus_connection, reply, NULL);
+    dbus_connection_flush(state->dbus_connection);
+    dbus_message_unref(reply);
+}
@@ -0,0 +1,11 @@
+#ifndef GOOEY_SHELL_SUPERVISOR_H
+#define GOOEY_SHELL_SUPERVISOR_H
+#include "gooey_shell.h"
+pid_t LaunchDesktopAppForMonitor(GooeyShellState *state, int monitor_number);
+void LaunchDesktopAppsForAllMonitors(GooeyShellState *state);
+void SyncDesktopApps(GooeyShellState *state, const int *new_to_old, int new_count);
+void StopDesktopApps(GooeyShellState *state);
+void AdoptDesktopAppWindow(GooeyShellState *state, WindowNode *node);
+void ReleaseDesktopAppWindow(GooeyShellState *state, Window frame);
+void HandleDesktopAppStatusCommand(GooeyShellState *state, DBusMessage *msg);
+#endif
@@ -3,11 +3,6 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-typedef struct SplitInfo
-{
-    TilingNode *split;
-    int is_left_child;
-} SplitInfo;
 void TilingNodeRef(TilingNode *node)
 {
     if (node != NULL)
@@ -22,9 +17,13 @@ void TilingNodeUnref(TilingNode *node)
         node->ref_count--;
         if (node->ref_count <= 0)
         {
+            if ((node->window != NULL) && (node->window->tiling_leaf == node))
+            {
+                node->window->tiling_leaf = NULL;
+            }
             FreeTilingTree(node->left);
             FreeTilingTree(node->right);
-            free(node);
+            PoolRelease(SHELL_POOL_TILING_NODE, node);
         }
     }
 }
@@ -38,7 +37,7 @@ void FreeTilingTree(TilingNode *root)
 TilingNode *CreateTilingNode(WindowNode *window, int x, int y, int width, int height)
 {
     TilingNode *node = NULL;
-    node = calloc(1, sizeof(TilingNode));
+    node = PoolAllocate(SHELL_POOL_TILING_NODE);
     if (node == NULL)
     {
         LogError("CreateTilingNode: Memory allocation failed");
@@ -56,102 +55,221 @@ TilingNode *CreateTilingNode(WindowNode *window, int x, int y, int width, int he
     node->split = SPLIT_NONE;
     node->is_leaf = (window != NULL) ? 1 : 0;
     node->ref_count = 1;
+    if (window != NULL)
+    {
+        window->tiling_leaf = node;
+    }
     return node;
 }
-SplitDirection ChooseSplitDirection(int width, int height, int window_count)
+static int IsTiledOnMonitor(const WindowNode *node, const Workspace *workspace, int monitor_number)
+{
+    return ((node->is_floating == 0) && (node->is_fullscreen == 0) &&
+            (node->is_minimized == 0) && (node->is_desktop_app == 0) &&
+            (node->is_fullscreen_app == 0) && (node->monitor_number == monitor_number) &&
+            (node->workspace == workspace->number)) ? 1 : 0;
+}
+static TilingNode *GetTilingRoot(TilingNode *node)
 {
-    if (window_count <= 1)
+    while ((node != NULL) && (node->parent != NULL))
     {
-        return SPLIT_NONE;
+        node = node->parent;
     }
-    if (width > (int)(height * 1.2f))
+    return node;
+}
+static TilingNode *FirstTilingLeaf(TilingNode *node)
+{
+    while ((node != NULL) && (node->is_leaf == 0))
     {
-        return SPLIT_VERTICAL;
+        node = node->left;
     }
-    else
+    return node;
+}
+static TilingNode *LastTilingLeaf(TilingNode *node)
+{
+    while ((node != NULL) && (node->is_leaf == 0))
     {
-        return SPLIT_HORIZONTAL;
+        node = node->right;
     }
+    return node;
 }
-int CountLeaves(TilingNode *node)
+static TilingNode *NextTilingLeaf(TilingNode *leaf)
 {
-    int count = 0;
-    if (node == NULL)
+    TilingNode *node = leaf;
+    while ((node->parent != NULL) && (node->parent->right == node))
     {
-        return 0;
+        node = node->parent;
     }
-    if (node->is_leaf != 0)
+    if (node->parent == NULL)
     {
-        return 1;
+        return NULL;
     }
-    count = CountLeaves(node->left);
-    count += CountLeaves(node->right);
-    return count;
+    return FirstTilingLeaf(node->parent->right);
 }
-static TilingNode *findExistingNode(TilingNode *current, WindowNode *target)
+static TilingNode **FindTilingRootSlot(GooeyShellState *state, TilingNode *root)
 {
-    TilingNode *found = NULL;
-    if (current == NULL)
+    Workspace *ws = state->workspaces;
+    int i = 0;
+    while (ws != NULL)
     {
-        return NULL;
+        for (i = 0; (ws->monitor_tiling_roots != NULL) && (i < ws->monitor_tiling_roots_count); i++)
+        {
+            if (ws->monitor_tiling_roots[i] == root)
+            {
+                return &ws->monitor_tiling_roots[i];
+            }
+        }
+        ws = ws->next;
+    }
+    return NULL;
+}
+void DetachWindowFromTilingTree(GooeyShellState *state, WindowNode *window)
+{
+    TilingNode *leaf = NULL;
+    TilingNode *parent = NULL;
+    TilingNode *sibling = NULL;
+    TilingNode **slot = NULL;
+    if ((state == NULL) || (window == NULL))
+    {
+        return;
+    }
+    if (state->tiling_focus == window)
+    {
+        state->tiling_focus = NULL;
+    }
+    leaf = window->tiling_leaf;
+    if (leaf == NULL)
+    {
+        return;
+    }
+    window->tiling_leaf = NULL;
+    leaf->window = NULL;
+    parent = leaf->parent;
+    if (parent == NULL)
+    {
+        slot = FindTilingRootSlot(state, leaf);
+        if (slot != NULL)
+        {
+            *slot = NULL;
+        }
+        TilingNodeUnref(leaf);
+        return;
+    }
+    sibling = (parent->left == leaf) ? parent->right : parent->left;
+    sibling->parent = parent->parent;
+    if (parent->parent == NULL)
+    {
+        slot = FindTilingRootSlot(state, parent);
+        if (slot != NULL)
+        {
+            *slot = sibling;
+        }
     }
-    if (current->window == target)
+    else if (parent->parent->left == parent)
     {
-        return current;
+        parent->parent->left = sibling;
     }
-    found = findExistingNode(current->left, target);
-    if (found != NULL)
+    else
     {
-        return found;
+        parent->parent->right = sibling;
     }
-    found = findExistingNode(current->right, target);
-    return found;
+    parent->left = NULL;
+    parent->right = NULL;
+    TilingNodeUnref(parent);
+    TilingNodeUnref(leaf);
 }
-static TilingNode *findSimilarSplit(TilingNode *current, int target_count)
+static int InsertWindowIntoTilingTree(GooeyShellState *state, Workspace *workspace,
+                                      int monitor_number, WindowNode *window)
 {
-    TilingNode *found = NULL;
-    if ((current == NULL) || (current->is_leaf != 0))
+    TilingNode *root = workspace->monitor_tiling_roots[monitor_number];
+    TilingNode *target = NULL;
+    TilingNode *split = NULL;
+    TilingNode *leaf = NULL;
+    if (root == NULL)
     {
-        return NULL;
+        leaf = CreateTilingNode(window, 0, 0, 0, 0);
+        workspace->monitor_tiling_roots[monitor_number] = leaf;
+        return (leaf != NULL) ? 1 : 0;
+    }
+    if ((state->tiling_focus != NULL) && (state->tiling_focus->tiling_leaf != NULL) &&
+        (GetTilingRoot(state->tiling_focus->tiling_leaf) == root))
+    {
+        target = state->tiling_focus->tiling_leaf;
+    }
+    else
+    {
+        target = LastTilingLeaf(root);
+    }
+    split = CreateTilingNode(NULL, target->x, target->y, target->width, target->height);
+    if (split == NULL)
+    {
+        return 0;
+    }
+    leaf = CreateTilingNode(window, 0, 0, 0, 0);
+    if (leaf == NULL)
+    {
+        TilingNodeUnref(split);
+        return 0;
+    }
+    split->split = ChooseSplitDirection(target->width, target->height, 2);
+    split->parent = target->parent;
+    if (target->parent == NULL)
+    {
+        workspace->monitor_tiling_roots[monitor_number] = split;
+    }
+    else if (target->parent->left == target)
+    {
+        target->parent->left = split;
+    }
+    else
+    {
+        target->parent->right = split;
+    }
+    split->left = target;
+    split->right = leaf;
+    target->parent = split;
+    leaf->parent = split;
+    return 1;
+}
+static int EnsureTilingScratch(GooeyShellState *state, int count)
+{
+    WindowNode **scratch = NULL;
+    int capacity = state->tiling_scratch_capacity;
+    if (count <= capacity)
+    {
+        return 1;
     }
-    if (CountLeaves(current) == target_count)
+    if (capacity == 0)
     {
-        return current;
+        capacity = 16;
     }
-    found = findSimilarSplit(current->left, target_count);
-    if (found != NULL)
+    while (capacity < count)
     {
-        return found;
+        capacity *= 2;
     }
-    found = findSimilarSplit(current->right, target_count);
-    return found;
+    scratch = realloc(state->tiling_scratch, sizeof(WindowNode *) * (size_t)capacity);
+    if (scratch == NULL)
+    {
+        LogError("EnsureTilingScratch: Memory allocation failed");
+        return 0;
+    }
+    state->tiling_scratch = scratch;
+    state->tiling_scratch_capacity = capacity;
+    return 1;
 }
-TilingNode *BuildTreeRecursive(WindowNode **windows, int count, int x, int y,
-                               int width, int height, TilingNode *existing_root)
+TilingNode *BuildTreeRecursive(WindowNode **windows, int count, int x, int y, int width, int height)
 {
     TilingNode *node = NULL;
+    LayoutBox box;
+    LayoutBox first;
+    LayoutBox second;
     int left_count = 0;
-    int right_count = 0;
     if (count == 0)
     {
         return NULL;
     }
     if (count == 1)
     {
-        node = CreateTilingNode(windows[0], x, y, width, height);
-        if (node == NULL)
-        {
-            return NULL;
-        }
-        if (existing_root != NULL)
-        {
-            TilingNode *existing = findExistingNode(existing_root, windows[0]);
-            if ((existing != NULL) && (existing->parent != NULL))
-            {
-                node->parent = existing->parent;
-            }
-        }
-        return node;
+        return CreateTilingNode(windows[0], x, y, width, height);
     }
     node = CreateTilingNode(NULL, x, y, width, height);
     if (node == NULL)
@@ -159,36 +277,15 @@ TilingNode *BuildTreeRecursive(WindowNode **windows, int count, int x, int y,
         return NULL;
     }
     node->split = ChooseSplitDirection(width, height, count);
-    if (existing_root != NULL)
-    {
-        TilingNode *similar = findSimilarSplit(existing_root, count);
-        if ((similar != NULL) && (similar->split == node->split))
-        {
-            node->ratio = similar->ratio;
-        }
-    }
     left_count = count / 2;
-    right_count = count - left_count;
-    if (node->split == SPLIT_VERTICAL)
-    {
-        int left_width = (int)((float)width * node->ratio);
-        int right_width = width - left_width;
-        node->left = BuildTreeRecursive(windows, left_count, x, y,
-                                        left_width, height, existing_root);
-        node->right = BuildTreeRecursive(windows + left_count, right_count,
-                                         x + left_width, y, right_width,
-                                         height, existing_root);
-    }
-    else
-    {
-        int left_height = (int)((float)height * node->ratio);
-        int right_height = height - left_height;
-        node->left = BuildTreeRecursive(windows, left_count, x, y,
-                                        width, left_height, existing_root);
-        node->right = BuildTreeRecursive(windows + left_count, right_count,
-                                         x, y + left_height, width,
-                                         right_height, existing_root);
-    }
+    box.x = x;
+    box.y = y;
+    box.width = width;
+    box.height = height;
+    SplitLayoutBox(&box, node->split, node->ratio, &first, &second);
+    node->left = BuildTreeRecursive(windows, left_count, first.x, first.y, first.width, first.height);
+    node->right = BuildTreeRecursive(windows + left_count, count - left_count,
+                                     second.x, second.y, second.width, second.height);
     if (node->left != NULL)
     {
         node->left->parent = node;
@@ -199,20 +296,44 @@ TilingNode *BuildTreeRecursive(WindowNode **windows, int count, int x, int y,
     }
     return node;
 }
+void UpdateTilingNodeGeometry(TilingNode *node, int x, int y, int width, int height)
+{
+    LayoutBox box;
+    LayoutBox first;
+    LayoutBox second;
+    if (node == NULL)
+    {
+        return;
+    }
+    node->x = x;
+    node->y = y;
+    node->width = width;
+    node->height = height;
+    if (node->is_leaf != 0)
+    {
+        return;
+    }
+    box.x = x;
+    box.y = y;
+    box.width = width;
+    box.height = height;
+    SplitLayoutBox(&box, node->split, node->ratio, &first, &second);
+    UpdateTilingNodeGeometry(node->left, first.x, first.y, first.width, first.height);
+    UpdateTilingNodeGeometry(node->right, second.x, second.y, second.width, second.height);
+}
 void BuildDynamicTilingTreeForMonitor(GooeyShellState *state, Workspace *workspace, int monitor_number)
 {
-    WindowNode **tiled_windows = NULL;
-    int tiled_count = 0;
     WindowNode *node = NULL;
+    TilingNode *leaf = NULL;
+    TilingNode *next = NULL;
     Monitor *mon = NULL;
     int bar_height = 0;
     int usable_width = 0;
     int usable_height = 0;
     int usable_x = 0;
     int usable_y = 0;
-    TilingNode *old_root = NULL;
-    TilingNode *new_root = NULL;
-    int index = 0;
+    int pending = 0;
+    int i = 0;
     if ((state == NULL) || (workspace == NULL))
     {
         LogError("BuildDynamicTilingTreeForMonitor: Invalid parameters");
@@ -223,66 +344,56 @@ void BuildDynamicTilingTreeForMonitor(GooeyShellState *state, Workspace *workspa
         LogError("BuildDynamicTilingTreeForMonitor: Invalid monitor number %d", monitor_number);
         return;
     }
-    old_root = workspace->monitor_tiling_roots[monitor_number];
-    node = workspace->windows;
-    while (node != NULL)
+    if (monitor_number < state->monitor_info.num_monitors)
     {
-        if ((node->is_floating == 0) && (node->is_fullscreen == 0) &&
-            (node->is_minimized == 0) && (node->is_desktop_app == 0) &&
-            (node->is_fullscreen_app == 0) && (node->monitor_number == monitor_number))
-        {
-            tiled_count++;
-        }
-        node = node->next;
+        mon = &state->monitor_info.monitors[monitor_number];
+        bar_height = (monitor_number == 0) ? BAR_HEIGHT : 0;
+        usable_width = mon->width - 2 * state->outer_gap;
+        usable_height = mon->height - 2 * state->outer_gap - bar_height;
+        usable_x = mon->x + state->outer_gap;
+        usable_y = mon->y + state->outer_gap + bar_height;
     }
-    if (tiled_count == 0)
+    leaf = FirstTilingLeaf(workspace->monitor_tiling_roots[monitor_number]);
+    while (leaf != NULL)
     {
-        if (old_root != NULL)
+        next = NextTilingLeaf(leaf);
+        if ((leaf->window != NULL) && (IsTiledOnMonitor(leaf->window, workspace, monitor_number) == 0))
         {
-            workspace->monitor_tiling_roots[monitor_number] = NULL;
-            TilingNodeUnref(old_root);
+            DetachWindowFromTilingTree(state, leaf->window);
         }
-        return;
-    }
-    tiled_windows = malloc(sizeof(WindowNode *) * (size_t)tiled_count);
-    if (tiled_windows == NULL)
-    {
-        LogError("BuildDynamicTilingTreeForMonitor: Memory allocation failed");
-        return;
+        leaf = next;
     }
     node = workspace->windows;
-    index = 0;
-    while ((node != NULL) && (index < tiled_count))
+    while (node != NULL)
     {
-        if ((node->is_floating == 0) && (node->is_fullscreen == 0) &&
-            (node->is_minimized == 0) && (node->is_desktop_app == 0) &&
-            (node->is_fullscreen_app == 0) && (node->monitor_number == monitor_number))
+        if ((IsTiledOnMonitor(node, workspace, monitor_number) != 0) &&
+            ((node->tiling_leaf == NULL) ||
+             (GetTilingRoot(node->tiling_leaf) != workspace->monitor_tiling_roots[monitor_number])))
         {
-            tiled_windows[index] = node;
-            index++;
+            if (EnsureTilingScratch(state, pending + 1) == 0)
+            {
+                break;
+            }
+            DetachWindowFromTilingTree(state, node);
+            state->tiling_scratch[pending] = node;
+            pending++;
         }
         node = node->next;
     }
-    if (monitor_number < state->monitor_info.num_monitors)
+    if ((pending > 1) && (workspace->monitor_tiling_roots[monitor_number] == NULL))
     {
-        mon = &state->monitor_info.monitors[monitor_number];
-        bar_height = (monitor_number == 0) ? BAR_HEIGHT : 0;
-        usable_width = mon->width - 2 * state->outer_gap;
-        usable_height = mon->height - 2 * state->outer_gap - bar_height;
-        usable_x = mon->x + state->outer_gap;
-        usable_y = mon->y + state->outer_gap + bar_height;
-        new_root = BuildTreeRecursive(tiled_windows, tiled_count, usable_x, usable_y,
-                                      usable_width, usable_height, old_root);
-        if (new_root != NULL)
-        {
-            workspace->monitor_tiling_roots[monitor_number] = new_root;
-        }
-        if (old_root != NULL)
+        workspace->monitor_tiling_roots[monitor_number] =
+            BuildTreeRecursive(state->tiling_scratch, pending, usable_x, usable_y, usable_width, usable_height);
+    }
+    else
+    {
+        for (i = pending - 1; i >= 0; i--)
         {
-            TilingNodeUnref(old_root);
+            (void)InsertWindowIntoTilingTree(state, workspace, monitor_number, state->tiling_scratch[i]);
         }
     }
-    free(tiled_windows);
+    UpdateTilingNodeGeometry(workspace->monitor_tiling_roots[monitor_number],
+                             usable_x, usable_y, usable_width, usable_height);
 }
 void BuildDynamicTilingTree(GooeyShellState *state, Workspace *workspace)
 {
@@ -297,47 +408,142 @@ void BuildDynamicTilingTree(GooeyShellState *state, Workspace *workspace)
         BuildDynamicTilingTreeForMonitor(state, workspace, i);
     }
 }
-void ArrangeTilingTree(GooeyShellState *state, TilingNode *node)
+void RebuildTilingTree(GooeyShellState *state, Workspace *workspace)
 {
+    TilingNode *root = NULL;
+    int i = 0;
+    if ((state == NULL) || (workspace == NULL))
+    {
+        LogError("RebuildTilingTree: Invalid parameters");
+        return;
+    }
+    for (i = 0; (workspace->monitor_tiling_roots != NULL) && (i < workspace->monitor_tiling_roots_count); i++)
+    {
+        root = workspace->monitor_tiling_roots[i];
+        workspace->monitor_tiling_roots[i] = NULL;
+        FreeTilingTree(root);
+    }
+    BuildDynamicTilingTree(state, workspace);
+}
+static LayoutRect *AppendLayoutRect(GooeyShellState *state, int *count)
+{
+    LayoutRect *rects = NULL;
+    LayoutItem *items = NULL;
+    LayoutBox *boxes = NULL;
+    int capacity = state->layout_rect_capacity;
+    if (*count >= capacity)
+    {
+        capacity = (capacity == 0) ? 16 : capacity * 2;
+        rects = realloc(state->layout_rects, sizeof(LayoutRect) * (size_t)capacity);
+        if (rects != NULL)
+        {
+            state->layout_rects = rects;
+        }
+        items = realloc(state->layout_items, sizeof(LayoutItem) * (size_t)capacity);
+        if (items != NULL)
+        {
+            state->layout_items = items;
+        }
+        boxes = realloc(state->layout_boxes, sizeof(LayoutBox) * (size_t)capacity);
+        if (boxes != NULL)
+        {
+            state->layout_boxes = boxes;
+        }
+        if ((rects == NULL) || (items == NULL) || (boxes == NULL))
+        {
+            LogError("AppendLayoutRect: Memory allocation failed");
+            return NULL;
+        }
+        state->layout_rect_capacity = capacity;
+    }
+    rects = &state->layout_rects[*count];
+    (*count)++;
+    return rects;
+}
+static int IsCommittedRect(const WindowNode *window, const LayoutRect *rect)
+{
+    const WindowGeometryState *committed = &window->committed_geometry;
+    return ((committed->valid != 0) && (committed->frame_x == rect->x) && (committed->frame_y == rect->y) &&
+            (committed->client_width == rect->width) && (committed->client_height == rect->height)) ? 1 : 0;
+}
+static int ApplyLayoutRects(GooeyShellState *state, int count)
+{
+    int changed = 0;
+    int i = 0;
+    for (i = 0; i < count; i++)
+    {
+        LayoutRect *rect = &state->layout_rects[i];
+        WindowNode *window = rect->window;
+        if (rect->width < 1)
+        {
+            rect->width = 1;
+        }
+        if (rect->height < 1)
+        {
+            rect->height = 1;
+        }
+        if ((window->x == rect->x) && (window->y == rect->y) &&
+            (window->width == rect->width) && (window->height == rect->height) &&
+            ((window->geometry_queued != 0) || (IsCommittedRect(window, rect) != 0)))
+        {
+            continue;
+        }
+        window->x = rect->x;
+        window->y = rect->y;
+        window->width = rect->width;
+        window->height = rect->height;
+        UpdateWindowGeometry(state, window);
+        changed++;
+    }
+    return changed;
+}
+static void CollectTilingRects(GooeyShellState *state, TilingNode *node, int *count)
+{
+    LayoutRect *rect = NULL;
     int gap = 0;
     int bar_height = 0;
-
-    if ((state == NULL) || (node == NULL))
+    if (node == NULL)
     {
         return;
     }
-
     if ((node->is_leaf != 0) && (node->window != NULL))
     {
-        gap = state->inner_gap;
-        node->window->x = node->x + gap;
-        node->window->y = node->y + gap;
-        node->window->width = node->width - 2 * gap;
-
-        bar_height = (node->window->monitor_number == 0) ? BAR_HEIGHT : 0;
-        node->window->height = node->height - 2 * gap - bar_height;
-
-        node->window->tiling_x = node->window->x;
-        node->window->tiling_y = node->window->y;
-        node->window->tiling_width = node->window->width;
-        node->window->tiling_height = node->window->height;
-
-        if (node->window->width < 1)
+        rect = AppendLayoutRect(state, count);
+        if (rect == NULL)
         {
-            node->window->width = 1;
+            return;
         }
-        if (node->window->height < 1)
-        {
-            node->window->height = 1;
-        }
-
-        UpdateWindowGeometry(state, node->window);
+        gap = state->inner_gap;
+        bar_height = (node->window->monitor_number == 0) ? BAR_HEIGHT : 0;
+        rect->window = node->window;
+        rect->x = node->x + gap;
+        rect->y = node->y + gap;
+        rect->width = node->width - 2 * gap;
+        rect->height = node->height - 2 * gap - bar_height;
+        node->window->tiling_x = rect->x;
+        node->window->tiling_y = rect->y;
+        node->window->tiling_width = rect->width;
+        node->window->tiling_height = rect->height;
     }
     else
     {
-        ArrangeTilingTree(state, node->left);
-        ArrangeTilingTree(state, node->right);
+        CollectTilingRects(state, node->left, count);
+        CollectTilingRects(state, node->right, count);
+    }
+}
+void ArrangeTilingTree(GooeyShellState *state, TilingNode *node)
+{
+    unsigned long long start = 0ULL;
+    int count = 0;
+    int changed = 0;
+    if ((state == NULL) || (node == NULL))
+    {
+        return;
     }
+    start = GetMonotonicTimeNs();
+    CollectTilingRects(state, node, &count);
+    changed = ApplyLayoutRects(state, count);
+    RecordLatency(&state->layout_stats[LAYOUT_TILING], GetMonotonicTimeNs() - start, (unsigned long)changed);
 }
 void ArrangeWindowsTilingOnMonitor(GooeyShellState *state, Workspace *workspace, int monitor_number)
 {
@@ -346,8 +552,12 @@ void ArrangeWindowsTilingOnMonitor(GooeyShellState *state, Workspace *workspace,
         LogError("ArrangeWindowsTilingOnMonitor: Invalid parameters");
         return;
     }
+    unsigned long long span_start = GetMonotonicTimeNs();
     BuildDynamicTilingTreeForMonitor(state, workspace, monitor_number);
+    TraceSpan(state, "BuildDynamicTilingTreeForMonitor", span_start, None);
+    span_start = GetMonotonicTimeNs();
     ArrangeTilingTree(state, workspace->monitor_tiling_roots[monitor_number]);
+    TraceSpan(state, "ArrangeTilingTree", span_start, None);
 }
 void ArrangeWindowsTiling(GooeyShellState *state, Workspace *workspace)
 {
@@ -362,61 +572,164 @@ void ArrangeWindowsTiling(GooeyShellState *state, Workspace *workspace)
         ArrangeWindowsTilingOnMonitor(state, workspace, i);
     }
 }
-void ArrangeWindowsMonocleOnMonitor(GooeyShellState *state, Workspace *workspace, int monitor_number)
+static StackRatios *GetStackRatios(Workspace *workspace, int monitor_number)
+{
+    if ((workspace->monitor_stack_ratios == NULL) || (monitor_number < 0) ||
+        (monitor_number >= workspace->monitor_tiling_roots_count))
+    {
+        return NULL;
+    }
+    return &workspace->monitor_stack_ratios[monitor_number];
+}
+static StackRatios *EnsureStackRatios(Workspace *workspace, int monitor_number, int stack_count)
+{
+    StackRatios *stack = GetStackRatios(workspace, monitor_number);
+    float *ratios = NULL;
+    float fill = 1.0f;
+    int i = 0;
+    if ((stack == NULL) || (stack_count <= 0) || (stack_count <= stack->count))
+    {
+        if ((stack != NULL) && (stack_count > 0))
+        {
+            stack->count = stack_count;
+        }
+        return stack;
+    }
+    if (stack->count > 0)
+    {
+        fill = 0.0f;
+        for (i = 0; i < stack->count; i++)
+        {
+            fill += stack->ratios[i];
+        }
+        fill /= (float)stack->count;
+    }
+    ratios = realloc(stack->ratios, sizeof(float) * (size_t)stack_count);
+    if (ratios == NULL)
+    {
+        LogError("EnsureStackRatios: Memory allocation failed");
+        return stack;
+    }
+    for (i = stack->count; i < stack_count; i++)
+    {
+        ratios[i] = fill;
+    }
+    stack->ratios = ratios;
+    stack->count = stack_count;
+    return stack;
+}
+void ArrangeWindowsLayoutOnMonitor(GooeyShellState *state, Workspace *workspace, int monitor_number, LayoutMode layout)
 {
     WindowNode *node = NULL;
+    LayoutRect *rect = NULL;
     Monitor *mon = NULL;
-    int usable_height = 0;
-    int usable_y = 0;
-
+    LayoutParams params;
+    LayoutBox area;
+    unsigned long long start = 0ULL;
+    int bar_height = 0;
+    int gap = 0;
+    int count = 0;
+    int placed = 0;
+    int changed = 0;
+    int i = 0;
     if ((state == NULL) || (workspace == NULL))
     {
-        LogError("ArrangeWindowsMonocleOnMonitor: Invalid parameters");
+        LogError("ArrangeWindowsLayoutOnMonitor: Invalid parameters");
         return;
     }
-
     if ((monitor_number < 0) || (monitor_number >= state->monitor_info.num_monitors))
     {
-        LogError("ArrangeWindowsMonocleOnMonitor: Invalid monitor number %d", monitor_number);
+        LogError("ArrangeWindowsLayoutOnMonitor: Invalid monitor number %d", monitor_number);
         return;
     }
-
+    start = GetMonotonicTimeNs();
     mon = &state->monitor_info.monitors[monitor_number];
-    int bar_height = (monitor_number == 0) ? BAR_HEIGHT : 0;
-    usable_height = mon->height - 2 * state->outer_gap - bar_height;
-    usable_y = mon->y + state->outer_gap + bar_height;
-
-    if (usable_height <= 0)
+    bar_height = (monitor_number == 0) ? BAR_HEIGHT : 0;
+    gap = state->inner_gap;
+    area.x = mon->x + state->outer_gap;
+    area.y = mon->y + state->outer_gap + bar_height;
+    area.width = mon->width - 2 * state->outer_gap;
+    area.height = mon->height - 2 * state->outer_gap - bar_height;
+    if (area.height <= 0)
     {
-        usable_height = 100;
+        area.height = 100;
     }
-
     node = workspace->windows;
     while (node != NULL)
     {
-        if ((node->is_floating == 0) && (node->is_fullscreen == 0) &&
-            (node->is_minimized == 0) && (node->is_desktop_app == 0) &&
-            (node->is_fullscreen_app == 0) && (node->monitor_number == monitor_number))
+        if (IsTiledOnMonitor(node, workspace, monitor_number) != 0)
         {
-
-            node->x = mon->x + state->outer_gap;
-            node->y = usable_y + state->inner_gap;
-            node->width = mon->width - 2 * state->outer_gap;
-            node->height = usable_height - 2 * state->inner_gap - bar_height;
-
-            if (node->width < 1)
+            rect = AppendLayoutRect(state, &count);
+            if (rect == NULL)
             {
-                node->width = 1;
-            }
-            if (node->height < 1)
-            {
-                node->height = 1;
+                break;
             }
-
-            UpdateWindowGeometry(state, node);
+            rect->window = node;
+            state->layout_items[count - 1].min_width = node->min_width;
+            state->layout_items[count - 1].min_height = node->min_height;
+            state->layout_items[count - 1].max_width = node->max_width;
+            state->layout_items[count - 1].max_height = node->max_height;
         }
         node = node->next;
     }
+    params.master_ratio = workspace->master_ratio;
+    params.stack_ratios = NULL;
+    params.stack_ratios_count = 0;
+    if (layout == LAYOUT_MASTER_STACK)
+    {
+        StackRatios *stack = EnsureStackRatios(workspace, monitor_number, count - 1);
+        if (stack != NULL)
+        {
+            params.stack_ratios = stack->ratios;
+            params.stack_ratios_count = stack->count;
+        }
+    }
+    placed = ComputeLayout(layout, &area, state->layout_items, count, &params, state->layout_boxes);
+    if (placed < 0)
+    {
+        return;
+    }
+    for (i = 0; i < placed; i++)
+    {
+        LayoutBox *box = &state->layout_boxes[i];
+        rect = &state->layout_rects[i];
+        if (layout == LAYOUT_MONOCLE)
+        {
+            rect->x = box->x;
+            rect->y = box->y + gap;
+            rect->width = box->width;
+            rect->height = box->height - 2 * gap - bar_height;
+        }
+        else
+        {
+            rect->x = box->x + gap;
+            rect->y = box->y + gap;
+            rect->width = box->width - 2 * gap;
+            rect->height = box->height - 2 * gap;
+        }
+    }
+    changed = ApplyLayoutRects(state, placed);
+    RecordLatency(&state->layout_stats[layout], GetMonotonicTimeNs() - start, (unsigned long)changed);
+}
+void ArrangeWindowsMonocleOnMonitor(GooeyShellState *state, Workspace *workspace, int monitor_number)
+{
+    ArrangeWindowsLayoutOnMonitor(state, workspace, monitor_number, LAYOUT_MONOCLE);
+}
+void ArrangeWindowsOnMonitor(GooeyShellState *state, Workspace *workspace, int monitor_number)
+{
+    if ((state == NULL) || (workspace == NULL))
+    {
+        LogError("ArrangeWindowsOnMonitor: Invalid parameters");
+        return;
+    }
+    if (workspace->layout == LAYOUT_TILING)
+    {
+        ArrangeWindowsTilingOnMonitor(state, workspace, monitor_number);
+    }
+    else if (GetLayoutEngine(workspace->layout) != NULL)
+    {
+        ArrangeWindowsLayoutOnMonitor(state, workspace, monitor_number, workspace->layout);
+    }
 }
 void ArrangeWindowsMonocle(GooeyShellState *state, Workspace *workspace)
 {
@@ -433,6 +746,7 @@ void ArrangeWindowsMonocle(GooeyShellState *state, Workspace *workspace)
 }
 void TileWindowsOnWorkspace(GooeyShellState *state, Workspace *workspace)
 {
+    int i = 0;
     if ((state == NULL) || (workspace == NULL))
     {
         LogError("TileWindowsOnWorkspace: Invalid parameters");
@@ -446,6 +760,13 @@ void TileWindowsOnWorkspace(GooeyShellState *state, Workspace *workspace)
     {
         ArrangeWindowsMonocle(state, workspace);
     }
+    else
+    {
+        for (i = 0; i < state->monitor_info.num_monitors; i++)
+        {
+            ArrangeWindowsOnMonitor(state, workspace, i);
+        }
+    }
 }
 int GetTilingResizeArea(GooeyShellState *state, WindowNode *node, int x, int y)
 {
@@ -475,42 +796,69 @@ int GetTilingResizeArea(GooeyShellState *state, WindowNode *node, int x, int y)
     }
     return 0;
 }
-static void collectSplits(TilingNode *current, WindowNode *target,
-                          SplitInfo *splits, int *split_count, int max_splits)
+static void ResizeMasterStack(GooeyShellState *state, Workspace *workspace, WindowNode *node,
+                              int resize_edge, int delta_x, int delta_y)
 {
-    int in_left = 0;
-    int in_right = 0;
-    if ((current == NULL) || (current->is_leaf != 0) || (*split_count >= max_splits))
+    WindowNode *current = NULL;
+    int index = -1;
+    int count = 0;
+    int stack_index = 0;
+    current = workspace->windows;
+    while (current != NULL)
+    {
+        if (IsTiledOnMonitor(current, workspace, node->monitor_number) != 0)
+        {
+            if (current == node)
+            {
+                index = count;
+            }
+            count++;
+        }
+        current = current->next;
+    }
+    if ((index < 0) || (count < 2))
     {
         return;
     }
-    in_left = IsWindowInSubtree(current->left, target);
-    in_right = IsWindowInSubtree(current->right, target);
-    if ((in_left != 0) || (in_right != 0))
+    if (resize_edge == 1)
     {
-        splits[*split_count].split = current;
-        splits[*split_count].is_left_child = (in_left != 0) ? 1 : 0;
-        (*split_count)++;
-        if (in_left != 0)
+        ResizeMasterArea(state, workspace, (index == 0) ? delta_x : -delta_x);
+    }
+    else if ((resize_edge == 2) && (index > 0))
+    {
+        (void)EnsureStackRatios(workspace, node->monitor_number, count - 1);
+        stack_index = index - 1;
+        if (stack_index < count - 2)
+        {
+            ResizeHorizontalSplit(state, workspace, node->monitor_number, stack_index, delta_y);
+        }
+        else if (stack_index > 0)
         {
-            collectSplits(current->left, target, splits, split_count, max_splits);
+            ResizeHorizontalSplit(state, workspace, node->monitor_number, stack_index - 1, -delta_y);
         }
-        if (in_right != 0)
+        else
         {
-            collectSplits(current->right, target, splits, split_count, max_splits);
+            return;
         }
     }
+    else
+    {
+        return;
+    }
+    ArrangeWindowsLayoutOnMonitor(state, workspace, node->monitor_number, LAYOUT_MASTER_STACK);
 }
 void HandleTilingResize(GooeyShellState *state, WindowNode *node,
                         int resize_edge, int delta_x, int delta_y)
 {
     Workspace *workspace = NULL;
-    SplitInfo splits[32];
-    int split_count = 0;
-    TilingNode *monitor_root = NULL;
+    SplitDirection orientation = SPLIT_NONE;
+    TilingNode *child = NULL;
+    TilingNode *split = NULL;
     TilingNode *target_split = NULL;
-    int i = 0;
+    TilingNode *fallback_split = NULL;
+    int fallback_is_left = 0;
     int is_left = 0;
+    int delta = 0;
     int direction = 0;
     float sensitivity = 0.03f;
     if ((state == NULL) || (node == NULL))
@@ -524,71 +872,67 @@ void HandleTilingResize(GooeyShellState *state, WindowNode *node,
         LogError("HandleTilingResize: No workspace or tiling roots");
         return;
     }
-    split_count = 0;
-    monitor_root = workspace->monitor_tiling_roots[node->monitor_number];
-    collectSplits(monitor_root, node, splits, &split_count, 32);
-    if (split_count == 0)
+    if (workspace->layout == LAYOUT_MASTER_STACK)
     {
+        ResizeMasterStack(state, workspace, node, resize_edge, delta_x, delta_y);
         return;
     }
-    target_split = NULL;
-    for (i = 0; i < split_count; i++)
+    if (workspace->layout != LAYOUT_TILING)
     {
-        TilingNode *split = splits[i].split;
-        int is_left_child = splits[i].is_left_child;
-        if (resize_edge == 1)
+        return;
+    }
+    if (resize_edge == 1)
+    {
+        orientation = SPLIT_VERTICAL;
+        delta = delta_x;
+    }
+    else if (resize_edge == 2)
+    {
+        orientation = SPLIT_HORIZONTAL;
+        delta = delta_y;
+    }
+    else
+    {
+        return;
+    }
+    child = node->tiling_leaf;
+    split = (child != NULL) ? child->parent : NULL;
+    while (split != NULL)
+    {
+        if (split->split == orientation)
         {
-            if (split->split == SPLIT_VERTICAL)
+            is_left = (split->left == child) ? 1 : 0;
+            if (((is_left != 0) && (delta > 0)) || ((is_left == 0) && (delta < 0)))
             {
-                if ((is_left_child != 0 && delta_x > 0) ||
-                    (is_left_child == 0 && delta_x < 0))
-                {
-                    target_split = split;
-                    is_left = is_left_child;
-                    break;
-                }
+                target_split = split;
+                break;
             }
-        }
-        else if (resize_edge == 2)
-        {
-            if (split->split == SPLIT_HORIZONTAL)
+            if (fallback_split == NULL)
             {
-                if ((is_left_child != 0 && delta_y > 0) ||
-                    (is_left_child == 0 && delta_y < 0))
-                {
-                    target_split = split;
-                    is_left = is_left_child;
-                    break;
-                }
+                fallback_split = split;
+                fallback_is_left = is_left;
             }
         }
+        child = split;
+        split = split->parent;
     }
     if (target_split == NULL)
     {
-        for (i = 0; i < split_count; i++)
-        {
-            TilingNode *split = splits[i].split;
-            if ((resize_edge == 1 && split->split == SPLIT_VERTICAL) ||
-                (resize_edge == 2 && split->split == SPLIT_HORIZONTAL))
-            {
-                target_split = split;
-                is_left = splits[i].is_left_child;
-                break;
-            }
-        }
+        target_split = fallback_split;
+        is_left = fallback_is_left;
     }
     if (target_split == NULL)
     {
         return;
     }
     direction = (is_left != 0) ? 1 : -1;
-    if ((resize_edge == 1) && (target_split->split == SPLIT_VERTICAL))
+    if (orientation == SPLIT_VERTICAL)
     {
-        target_split->ratio += direction * (float)delta_x / (float)target_split->width * sensitivity;
+        target_split->ratio += direction * (float)delta / (float)target_split->width * sensitivity;
     }
-    else if ((resize_edge == 2) && (target_split->split == SPLIT_HORIZONTAL))
+    else
     {
-        target_split->ratio += direction * (float)delta_y / (float)target_split->height * sensitivity;
+        target_split->ratio += direction * (float)delta / (float)target_split->height * sensitivity;
     }
     if (target_split->ratio < 0.1f)
     {
@@ -598,10 +942,12 @@ void HandleTilingResize(GooeyShellState *state, WindowNode *node,
     {
         target_split->ratio = 0.9f;
     }
-    LogInfo("HandleTilingResize: Resizing split: %s, ratio: %.2f, direction: %d",
+    LogDebug("HandleTilingResize: Resizing split: %s, ratio: %.2f, direction: %d",
             target_split->split == SPLIT_VERTICAL ? "vertical" : "horizontal",
             target_split->ratio, direction);
-    TileWindowsOnWorkspace(state, workspace);
+    UpdateTilingNodeGeometry(target_split, target_split->x, target_split->y,
+                             target_split->width, target_split->height);
+    ArrangeTilingTree(state, target_split);
 }
 void ResizeMasterArea(GooeyShellState *state, Workspace *workspace, int delta_width)
 {
@@ -630,79 +976,77 @@ void ResizeMasterArea(GooeyShellState *state, Workspace *workspace, int delta_wi
         workspace->master_ratio = 0.9f;
     }
 }
-void ResizeHorizontalSplit(GooeyShellState *state, Workspace *workspace,
+void ResizeHorizontalSplit(GooeyShellState *state, Workspace *workspace, int monitor_number,
                            int split_index, int delta_height)
 {
+    StackRatios *stack = NULL;
     Monitor *mon = NULL;
     int usable_height = 0;
     float ratio_change = 0.0f;
     float min_ratio = 0.1f;
-    if ((state == NULL) || (workspace == NULL))
+    if ((state == NULL) || (workspace == NULL) ||
+        (monitor_number < 0) || (monitor_number >= state->monitor_info.num_monitors))
     {
         LogError("ResizeHorizontalSplit: Invalid parameters");
         return;
     }
-    if ((workspace->stack_ratios == NULL) || (split_index < 0) ||
-        (split_index >= workspace->stack_ratios_count - 1))
+    stack = GetStackRatios(workspace, monitor_number);
+    if ((stack == NULL) || (stack->ratios == NULL) || (split_index < 0) ||
+        (split_index >= stack->count - 1))
     {
         LogError("ResizeHorizontalSplit: Invalid split index %d", split_index);
         return;
     }
-    mon = &state->monitor_info.monitors[0];
-    usable_height = mon->height - 2 * state->outer_gap - BAR_HEIGHT;
+    mon = &state->monitor_info.monitors[monitor_number];
+    usable_height = mon->height - 2 * state->outer_gap - ((monitor_number == 0) ? BAR_HEIGHT : 0);
     if (usable_height <= 0)
     {
         usable_height = 1;
     }
     ratio_change = (float)delta_height / (float)usable_height;
-    workspace->stack_ratios[split_index] += ratio_change;
-    workspace->stack_ratios[split_index + 1] -= ratio_change;
-    if (workspace->stack_ratios[split_index] < min_ratio)
+    stack->ratios[split_index] += ratio_change;
+    stack->ratios[split_index + 1] -= ratio_change;
+    if (stack->ratios[split_index] < min_ratio)
     {
-        workspace->stack_ratios[split_index + 1] += (workspace->stack_ratios[split_index] - min_ratio);
-        workspace->stack_ratios[split_index] = min_ratio;
+        stack->ratios[split_index + 1] += (stack->ratios[split_index] - min_ratio);
+        stack->ratios[split_index] = min_ratio;
     }
-    if (workspace->stack_ratios[split_index + 1] < min_ratio)
+    if (stack->ratios[split_index + 1] < min_ratio)
     {
-        workspace->stack_ratios[split_index] += (workspace->stack_ratios[split_index + 1] - min_ratio);
-        workspace->stack_ratios[split_index + 1] = min_ratio;
+        stack->ratios[split_index] += (stack->ratios[split_index + 1] - min_ratio);
+        stack->ratios[split_index + 1] = min_ratio;
     }
 }
 void FocusWindow(GooeyShellState *state, WindowNode *node)
 {
-    WindowNode *current = NULL;
+    WindowNode *previous = NULL;
     if ((state == NULL) || (node == NULL))
     {
         LogError("FocusWindow: Invalid parameters");
         return;
     }
-    current = state->window_list;
-    while (current != NULL)
+    if (node->frame == None)
     {
-        if ((current != node) && (current->frame != None) &&
-            (current->is_desktop_app == 0) && (current->is_fullscreen_app == 0) &&
-            (current->is_minimized == 0))
-        {
-            XSetWindowBorder(state->display, current->frame, state->border_color);
-            if (current->is_titlebar_disabled == 0)
-            {
-                DrawTitleBar(state, current);
-            }
-        }
-        current = current->next;
+        return;
     }
-    if (node->frame != None)
+    if ((state->focused_window != None) && (state->focused_window != node->frame))
     {
-        XSetWindowBorder(state->display, node->frame, state->focused_border_color);
-        if (node->is_titlebar_disabled == 0)
-        {
-            DrawTitleBar(state, node);
-        }
-        XSetInputFocus(state->display, node->client, RevertToParent, CurrentTime);
-        state->focused_window = node->frame;
-        XRaiseWindow(state->display, node->frame);
-        SendWindowStateThroughDBus(state, node->frame, "focused");
+        previous = FindWindowNodeByFrame(state, state->focused_window);
     }
+    state->focused_window = node->frame;
+    if (node->tiling_leaf != NULL)
+    {
+        state->tiling_focus = node;
+    }
+    if (previous != NULL)
+    {
+        RepaintFocusDecorations(state, previous);
+    }
+    RepaintFocusDecorations(state, node);
+    XSetInputFocus(state->display, node->client, RevertToParent, CurrentTime);
+    RaiseWindowNode(state, node);
+    state->focus_signal_pending = 1;
+    state->snapshot_dirty = 1;
     OptimizedXFlush(state);
 }
 WindowNode *GetNextWindow(GooeyShellState *state, WindowNode *current)
@@ -825,7 +1169,7 @@ void GooeyShell_TileWindows(GooeyShellState *state)
         LogError("GooeyShell_TileWindows: NULL state pointer");
         return;
     }
-    LogInfo("GooeyShell_TileWindows called");
+    LogDebug("GooeyShell_TileWindows called");
     workspace = GetCurrentWorkspace(state);
     if (workspace != NULL)
     {
@@ -840,7 +1184,7 @@ void GooeyShell_TileWindows(GooeyShellState *state)
             }
             node = node->next;
         }
-        LogInfo("GooeyShell_TileWindows: Tiling %d windows on workspace %d",
+        LogDebug("GooeyShell_TileWindows: Tiling %d windows on workspace %d",
                 tiled_count, workspace->number);
         TileWindowsOnWorkspace(state, workspace);
     }
@@ -857,7 +1201,7 @@ void GooeyShell_TileWindowsOnMonitor(GooeyShellState *state, int monitor_number)
     if ((workspace != NULL) && (monitor_number >= 0) &&
         (monitor_number < state->monitor_info.num_monitors))
     {
-        ArrangeWindowsTilingOnMonitor(state, workspace, monitor_number);
+        ArrangeWindowsOnMonitor(state, workspace, monitor_number);
     }
 }
 void GooeyShell_RetileAllMonitors(GooeyShellState *state)
@@ -898,6 +1242,7 @@ void GooeyShell_ToggleFloating(GooeyShellState *state, Window client)
     old_width = node->width;
     old_height = node->height;
     node->is_floating = (node->is_floating == 0) ? 1 : 0;
+    state->snapshot_dirty = 1;
     if (node->is_floating == 0)
     {
         LogInfo("GooeyShell_ToggleFloating: Window returning to tiling layout");
@@ -909,6 +1254,7 @@ void GooeyShell_ToggleFloating(GooeyShellState *state, Window client)
             node->width = node->tiling_width;
             node->height = node->tiling_height;
         }
+        UpdateWindowGeometry(state, node);
         GooeyShell_TileWindows(state);
     }
     else
@@ -939,7 +1285,7 @@ void GooeyShell_ToggleFloating(GooeyShellState *state, Window client)
                 node->y = mon->y + bar_height;
             }
             UpdateWindowGeometry(state, node);
-            XRaiseWindow(state->display, node->frame);
+            RaiseWindowNode(state, node);
         }
     }
 }
@@ -1111,6 +1457,7 @@ void GooeyShell_MoveWindowToWorkspace(GooeyShellState *state, Window client, int
 void GooeyShell_SwitchWorkspace(GooeyShellState *state, int workspace)
 {
     WindowNode *node = NULL;
+    unsigned long long span_start = GetMonotonicTimeNs();
     int old_workspace = 0;
     if (state == NULL)
     {
@@ -1145,9 +1492,9 @@ void GooeyShell_SwitchWorkspace(GooeyShellState *state, int workspace)
         }
         node = node->next;
     }
-    SendWorkspaceChangedThroughDBus(state, old_workspace, workspace);
+    QueueWorkspaceChangedSignal(state, old_workspace, workspace);
     GooeyShell_TileWindows(state);
-    RegrabKeys(state);
+    TraceSpan(state, "SwitchWorkspace", span_start, None);
 }
 void GooeyShell_SetLayout(GooeyShellState *state, LayoutMode layout)
 {
@@ -1160,91 +1507,12 @@ void GooeyShell_SetLayout(GooeyShellState *state, LayoutMode layout)
     workspace = GetCurrentWorkspace(state);
     if (workspace != NULL)
     {
+        if ((layout == LAYOUT_TILING) && (workspace->layout == LAYOUT_TILING))
+        {
+            RebuildTilingTree(state, workspace);
+        }
         workspace->layout = layout;
         state->current_layout = layout;
         TileWindowsOnWorkspace(state, workspace);
     }
 }
-int IsWindowInSubtree(TilingNode *root, WindowNode *target)
-{
-    int found = 0;
-    if (root == NULL)
-    {
-        return 0;
-    }
-    if (root->is_leaf != 0)
-    {
-        return (root->window == target) ? 1 : 0;
-    }
-    found = IsWindowInSubtree(root->left, target);
-    if (found != 0)
-    {
-        return 1;
-    }
-    found = IsWindowInSubtree(root->right, target);
-    return found;
-}
-TilingNode *findContainingSplit(TilingNode *root, WindowNode *target)
-{
-    int in_left = 0;
-    int in_right = 0;
-    if ((root == NULL) || (root->is_leaf != 0))
-    {
-        return NULL;
-    }
-    in_left = IsWindowInSubtree(root->left, target);
-    in_right = IsWindowInSubtree(root->right, target);
-    if ((in_left != 0) && (in_right != 0))
-    {
-        return NULL;
-    }
-    if ((in_left != 0) || (in_right != 0))
-    {
-        return root;
-    }
-    return NULL;
-}
-TilingNode *findVerticalSplitToLeft(TilingNode *root, WindowNode *target)
-{
-    TilingNode *found = NULL;
-    if ((root == NULL) || (root->is_leaf != 0))
-    {
-        return NULL;
-    }
-    if (root->split == SPLIT_VERTICAL)
-    {
-        if (IsWindowInSubtree(root->right, target) != 0)
-        {
-            return root;
-        }
-    }
-    found = findVerticalSplitToLeft(root->left, target);
-    if (found != NULL)
-    {
-        return found;
-    }
-    found = findVerticalSplitToLeft(root->right, target);
-    return found;
-}
-TilingNode *findVerticalSplitToRight(TilingNode *root, WindowNode *target)
-{
-    TilingNode *found = NULL;
-    if ((root == NULL) || (root->is_leaf != 0))
-    {
-        return NULL;
-    }
-    if (root->split == SPLIT_VERTICAL)
-    {
-        if (IsWindowInSubtree(root->left, target) != 0)
-        {
-            return root;
-        }
-    }
-    found = findVerticalSplitToRight(root->left, target);
-    if (found != NULL)
-    {
-        return found;
-    }
-    found = findVerticalSplitToRight(root->right, target);
-    return found;
-}
\ No newline at end of file
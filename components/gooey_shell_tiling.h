@@ -17,16 +17,17 @@ int GetTilingResizeArea(GooeyShellState *state, WindowNode *node, int x, int y);
 void HandleTilingResize(GooeyShellState *state, WindowNode *node, int resize_edge, int delta_x, int delta_y);
 void ResizeMasterArea(GooeyShellState *state, Workspace *workspace, int delta_width);
 void ResizeStackWindow(GooeyShellState *state, Workspace *workspace, int window_index, int delta_height);
-void ResizeHorizontalSplit(GooeyShellState *state, Workspace *workspace, int split_index, int delta_height);
+void ResizeHorizontalSplit(GooeyShellState *state, Workspace *workspace, int monitor_number,
+                           int split_index, int delta_height);
 TilingNode *CreateTilingNode(WindowNode *window, int x, int y, int width, int height);
 void FreeTilingTree(TilingNode *root);
 void BuildDynamicTilingTree(GooeyShellState *state, Workspace *workspace);
+void RebuildTilingTree(GooeyShellState *state, Workspace *workspace);
+void DetachWindowFromTilingTree(GooeyShellState *state, WindowNode *window);
 void ArrangeTilingTree(GooeyShellState *state, TilingNode *node);
-SplitDirection ChooseSplitDirection(int width, int height, int window_count);
-TilingNode *BuildTreeRecursive(WindowNode **windows, int count, int x, int y, int width, int height, TilingNode *existing_root);
+TilingNode *BuildTreeRecursive(WindowNode **windows, int count, int x, int y, int width, int height);
 void UpdateTilingNodeGeometry(TilingNode *node, int x, int y, int width, int height);
 void CleanupWorkspace(Workspace *ws);
-void LaunchDesktopAppsForAllMonitors(GooeyShellState *state);
 void MoveWindowToMonitor(GooeyShellState *state, WindowNode *node, int monitor_number);
 void SetWindowOpacity(GooeyShellState *state, Window window, float opacity);
 void InitializeTransparency(GooeyShellState *state);
@@ -35,12 +36,10 @@ int GetCurrentMonitor(GooeyShellState *state);
 void BuildDynamicTilingTreeForMonitor(GooeyShellState *state, Workspace *workspace, int monitor_number);
 void ArrangeWindowsTilingOnMonitor(GooeyShellState *state, Workspace *workspace, int monitor_number);
 void ArrangeWindowsMonocleOnMonitor(GooeyShellState *state, Workspace *workspace, int monitor_number);
+void ArrangeWindowsLayoutOnMonitor(GooeyShellState *state, Workspace *workspace, int monitor_number, LayoutMode layout);
+void ArrangeWindowsOnMonitor(GooeyShellState *state, Workspace *workspace, int monitor_number);
 void TilingNodeRef(TilingNode *node);
 void TilingNodeUnref(TilingNode *node);
-int IsWindowInSubtree(TilingNode *root, WindowNode *target);
-TilingNode *findContainingSplit(TilingNode *root, WindowNode *target);
-TilingNode *findVerticalSplitToLeft(TilingNode *root, WindowNode *target);
-TilingNode *findVerticalSplitToRight(TilingNode *root, WindowNode *target);
 void GooeyShell_TileWindows(GooeyShellState *state);
 void GooeyShell_TileWindowsOnMonitor(GooeyShellState *state, int monitor_number);
 void GooeyShell_RetileAllMonitors(GooeyShellState *state);
@@ -0,0 +1,112 @@
+#include "gooey_shell.h"
+#include "gooey_shell_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+static atomic_uint trace_dump_sequence = 0;
+void TraceSpan(GooeyShellState *state, const char *name, unsigned long long start_ns, Window window)
+{
+    TraceEvent *event = &state->trace_events[state->trace_count & (TRACE_RING_SIZE - 1)];
+    event->name = name;
+    event->start_ns = start_ns;
+    event->duration_ns = GetMonotonicTimeNs() - start_ns;
+    event->window = window;
+    state->trace_count++;
+}
+int MakeTraceDumpPath(char *buffer, size_t size)
+{
+    const char *dir = getenv("XDG_RUNTIME_DIR");
+    unsigned int sequence = atomic_fetch_add(&trace_dump_sequence, 1);
+    int written = snprintf(buffer, size, "%s/gooey-shell-trace-%d-%u.json", (dir != NULL) ? dir : "/tmp",
+                           (int)getpid(), sequence);
+    return ((written > 0) && ((size_t)written < size)) ? 1 : 0;
+}
+int DumpTraceRing(GooeyShellState *state, const char *path)
+{
+    char default_path[PATH_MAX];
+    unsigned long first = 0;
+    unsigned long i = 0;
+    int pid = (int)getpid();
+    int fd = -1;
+    FILE *file = NULL;
+    if (state == NULL)
+    {
+        return 0;
+    }
+    if (path == NULL)
+    {
+        if (MakeTraceDumpPath(default_path, sizeof(default_path)) == 0)
+        {
+            return 0;
+        }
+        path = default_path;
+    }
+    fd = open(path, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd < 0)
+    {
+        LogError("DumpTraceRing: Failed to open %s: %s", path, strerror(errno));
+        return 0;
+    }
+    file = fdopen(fd, "w");
+    if (file == NULL)
+    {
+        LogError("DumpTraceRing: Failed to open %s: %s", path, strerror(errno));
+        (void)close(fd);
+        return 0;
+    }
+    first = (state->trace_count > TRACE_RING_SIZE) ? state->trace_count - TRACE_RING_SIZE : 0;
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+    for (i = first; i < state->trace_count; i++)
+    {
+        const TraceEvent *event = &state->trace_events[i & (TRACE_RING_SIZE - 1)];
+        fprintf(file, "%s\n{\"name\":\"%s\",\"cat\":\"shell\",\"ph\":\"X\",\"ts\":%llu.%03llu,\"dur\":%llu.%03llu,"
+                      "\"pid\":%d,\"tid\":%d,\"args\":{\"window\":\"0x%lx\"}}",
+                (i == first) ? "" : ",", event->name, event->start_ns / 1000ULL, event->start_ns % 1000ULL,
+                event->duration_ns / 1000ULL, event->duration_ns % 1000ULL, pid, pid, event->window);
+    }
+    fputs("\n]}\n", file);
+    if (fclose(file) != 0)
+    {
+        LogError("DumpTraceRing: Failed to write %s", path);
+        return 0;
+    }
+    LogInfo("DumpTraceRing: Wrote %lu spans to %s", state->trace_count - first, path);
+    return 1;
+}
+void HandleDumpTraceCommand(GooeyShellState *state, DBusMessage *msg)
+{
+    char path[PATH_MAX];
+    const char *path_str = path;
+    DBusMessage *reply = NULL;
+    if ((state == NULL) || (msg == NULL))
+    {
+        return;
+    }
+    if (MakeTraceDumpPath(path, sizeof(path)) == 0)
+    {
+        reply = dbus_message_new_error(msg, DBUS_ERROR_FAILED, "Trace dump path too long");
+    }
+    else if (EnqueueShellCommand(state, SHELL_COMMAND_DUMP_TRACE, None, path) != 0)
+    {
+        reply = dbus_message_new_error(msg, SHELL_ERROR_QUEUE_FULL, "Shell command queue is full");
+    }
+    else
+    {
+        reply = dbus_message_new_method_return(msg);
+        if (reply != NULL)
+        {
+            dbus_message_append_args(reply, DBUS_TYPE_STRING, &path_str, DBUS_TYPE_INVALID);
+        }
+    }
+    if (reply != NULL)
+    {
+        dbus_connection_send(state->dbus_connection, reply, NULL);
+        dbus_connection_flush(state->dbus_connection);
+        dbus_message_unref(reply);
+    }
+}
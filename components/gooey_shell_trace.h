@@ -0,0 +1,8 @@
+#ifndef GOOEY_SHELL_TRACE_H
+#define GOOEY_SHELL_TRACE_H
+#include "gooey_shell.h"
+void TraceSpan(GooeyShellState *state, const char *name, unsigned long long start_ns, Window window);
+int DumpTraceRing(GooeyShellState *state, const char *path);
+int MakeTraceDumpPath(char *buffer, size_t size);
+void HandleDumpTraceCommand(GooeyShellState *state, DBusMessage *msg);
+#endif